@@ -0,0 +1,76 @@
+#include "AllocationCheck.h"
+#include "AllocationCounter.h"
+#include "FunctionParser.h"
+#include "GraphRenderer.h"
+#include "UserDefinedFunction.h"
+
+#include <SFML/Graphics.hpp>
+#include <cstdio>
+#include <vector>
+
+int runAllocationCheck(unsigned frames) {
+    if (!AllocationCounter::enabled()) {
+        std::fprintf(stderr, "Allocation counting is not compiled in; build with GRAPHPLOTTER_COUNT_ALLOCATIONS (Debug).\n");
+        return 1;
+    }
+
+    sf::Font font;
+    if (!font.loadFromFile("assets/fonts/SamsungOne-400.ttf")) {
+        std::fprintf(stderr, "Failed to load font: assets/fonts/SamsungOne-400.ttf\n");
+        return 1;
+    }
+
+    sf::RenderTexture target;
+    if (!target.create(800, 600)) {
+        std::fprintf(stderr, "Failed to create the off-screen render target\n");
+        return 1;
+    }
+
+    // Curves with poles and domain errors; the shaded area crosses the edge of sqrt's domain
+    FunctionParser parser;
+    std::vector<UserDefinedFunction> functions;
+    functions.emplace_back(parser.parse("sqrt(x)"), sf::Color::Red);
+    functions.emplace_back(parser.parse("log(x)"), sf::Color::Blue);
+    functions.emplace_back(parser.parse("tan(x)"), sf::Color(0, 150, 0));
+    functions.emplace_back(parser.parse("1 / (x - 1)"), sf::Color(150, 0, 200));
+    functions.emplace_back(parser.parse("sin(x)"), sf::Color(220, 120, 0));
+
+    GraphRenderer renderer;
+    renderer.setFont(font);
+
+    auto frame = [&]() {
+        target.clear(sf::Color::White);
+        renderer.draw(target, functions);
+        renderer.drawArea(target, functions[0], nullptr, -2.f, 2.f, sf::Color(255, 0, 0, 60));
+        renderer.drawArea(target, functions[1], &functions[4], -2.f, 2.f, sf::Color(0, 0, 255, 60));
+        target.display();
+    };
+
+    // The first frames size the pooled buffers, the glyph cache and the GL state
+    const unsigned warmup = 5;
+    for (unsigned i = 0; i < warmup; ++i)
+        frame();
+
+    unsigned long long total = 0;
+    unsigned long long worst = 0;
+    unsigned failed = 0;
+
+    for (unsigned i = 0; i < frames; ++i) {
+        unsigned long long before = AllocationCounter::count();
+        frame();
+        unsigned long long allocations = AllocationCounter::count() - before;
+
+        total += allocations;
+        if (allocations > worst) worst = allocations;
+        if (allocations > 0) ++failed;
+    }
+
+    std::printf("%u frames after %u warm-up: %llu allocations, at most %llu in one frame\n", frames, warmup, total, worst);
+    if (failed > 0) {
+        std::printf("FAIL: %u frames allocated\n", failed);
+        return 1;
+    }
+
+    std::printf("OK: steady-state redraw does not allocate\n");
+    return 0;
+}
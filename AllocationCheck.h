@@ -0,0 +1,7 @@
+#pragma once
+
+// Steady-state allocation check for the renderer, reachable from the command line:
+//   GraphPlotter --check-allocations [frames]
+// Redraws a fixed scene off-screen and fails (non-zero) if any frame after warm-up
+// allocates. Needs a build with GRAPHPLOTTER_COUNT_ALLOCATIONS (the Debug configurations).
+int runAllocationCheck(unsigned frames);
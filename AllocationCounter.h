@@ -0,0 +1,11 @@
+#pragma once
+
+// Counts heap allocations made through operator new.
+//
+// The global operator new/delete are only replaced when GRAPHPLOTTER_COUNT_ALLOCATIONS
+// is defined (the Debug configurations); otherwise counting is disabled and count()
+// always returns 0.
+namespace AllocationCounter {
+    bool enabled();
+    unsigned long long count(); // Allocations since startup, across all threads
+}
@@ -1,5 +1,9 @@
 #include "Application.h"
+#include "AllocationCounter.h"
 #include <iostream>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
 
 Application::Application()
     : window(sf::VideoMode(800, 600), "Graph Plotter") 
@@ -10,26 +14,31 @@ Application::Application()
     }
 
     renderer.setFont(font);
+    areaLabel = CachedText(font, 14, sf::Color::Black);
+    hintLabel = CachedText(font, 14, sf::Color(120, 120, 120));
+    hintLabel.setString("Press N to add a function");
 }
 
 void Application::run() {
-    // Example: read function
-    std::cout << "Enter a function (e.g., sin(x) + x^2): ";
-    std::string expr;
-    std::getline(std::cin, expr);
+    std::cout << "Press N to add a function, Enter to edit the selected one, Tab to select the next.\n"
+              << "Zoom with +/-, pan with the arrow keys.\n"
+              << "Press I to shade the integral, drag its bounds with the mouse.\n"
+              << "Press F to switch the selected function between exact and fast math.\n";
 
-    try {
-        FunctionParser parser;
-        auto tree = parser.parse(expr);
-        functions.emplace_back(tree, sf::Color::Red);
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Parse error: " << e.what() << '\n';
-    }
+    // Open straight into editing the first function
+    startEditing(true);
+    swallowText = false;
+
+    if (AllocationCounter::enabled())
+        std::cout << "Counting allocations per frame.\n";
 
     while (window.isOpen()) {
         processInput();
+
+        unsigned long long before = AllocationCounter::count();
         render();
+        if (AllocationCounter::enabled())
+            reportAllocations(AllocationCounter::count() - before);
     }
 }
 
@@ -38,18 +47,250 @@ void Application::processInput() {
     while (window.pollEvent(event)) {
         if (event.type == sf::Event::Closed)
             window.close();
+        else if (event.type == sf::Event::TextEntered) {
+            bool swallow = swallowText && (event.text.unicode == 'n' || event.text.unicode == 'N');
+            swallowText = false;
+            if (editing && !swallow)
+                handleEditorText(event.text.unicode);
+        }
+        else if (event.type == sf::Event::KeyPressed && editing) {
+            handleEditorKey(event.key.code);
+        }
         // Zoom with +/-
         else if (event.type == sf::Event::KeyPressed) {
             if (event.key.code == sf::Keyboard::Add)
                 renderer.zoom(1.1f);
             else if (event.key.code == sf::Keyboard::Subtract)
                 renderer.zoom(0.9f);
+            else if (event.key.code == sf::Keyboard::I && integrator)
+                showArea = !showArea;
+            else if (event.key.code == sf::Keyboard::F)
+                toggleMathBackend();
+            // Pan with the arrow keys
+            else if (event.key.code == sf::Keyboard::Left)
+                renderer.pan(40.f, 0.f);
+            else if (event.key.code == sf::Keyboard::Right)
+                renderer.pan(-40.f, 0.f);
+            else if (event.key.code == sf::Keyboard::Up)
+                renderer.pan(0.f, 40.f);
+            else if (event.key.code == sf::Keyboard::Down)
+                renderer.pan(0.f, -40.f);
+            // Function list
+            else if (event.key.code == sf::Keyboard::N)
+                startEditing(true);
+            else if (event.key.code == sf::Keyboard::Enter)
+                startEditing(selected < 0);
+            else if (event.key.code == sf::Keyboard::Tab && !editors.empty())
+                selected = (selected + 1) % static_cast<int>(editors.size());
+            else if (event.key.code == sf::Keyboard::Delete && selected >= 0) {
+                editors.erase(editors.begin() + selected);
+                selected = std::min(selected, static_cast<int>(editors.size()) - 1);
+                rebuildPlots();
+            }
+        }
+        // Grab the nearest integration bound within a few pixels
+        else if (event.type == sf::Event::MouseButtonPressed && showArea && event.mouseButton.button == sf::Mouse::Left) {
+            float px = static_cast<float>(event.mouseButton.x);
+            float distFrom = std::abs(px - renderer.worldToScreenX(areaFrom));
+            float distTo = std::abs(px - renderer.worldToScreenX(areaTo));
+            const float grabDistance = 6.f;
+
+            if (distFrom <= grabDistance && distFrom <= distTo) draggedBound = 0;
+            else if (distTo <= grabDistance) draggedBound = 1;
+        }
+        else if (event.type == sf::Event::MouseButtonReleased) {
+            draggedBound = -1;
+        }
+        else if (event.type == sf::Event::MouseMoved && draggedBound >= 0) {
+            float x = renderer.screenToWorldX(static_cast<float>(event.mouseMove.x));
+            if (draggedBound == 0) areaFrom = x;
+            else areaTo = x;
+            updateArea();
+        }
+    }
+}
+
+// Selects a new empty expression (or the current one) and routes keystrokes to it
+void Application::startEditing(bool newExpression) {
+    if (newExpression) {
+        editors.emplace_back("");
+        selected = static_cast<int>(editors.size()) - 1;
+        swallowText = true; // The N that created it arrives next as text
+    }
+    editing = true;
+}
+
+// Navigation and deletion while editing; printable characters come through handleEditorText
+void Application::handleEditorKey(sf::Keyboard::Key key) {
+    ExpressionEditor& editor = editors[selected];
+    bool changed = false;
+
+    if (key == sf::Keyboard::Enter || key == sf::Keyboard::Escape)
+        editing = false;
+    else if (key == sf::Keyboard::Left)
+        editor.moveCursor(-1);
+    else if (key == sf::Keyboard::Right)
+        editor.moveCursor(1);
+    else if (key == sf::Keyboard::Home)
+        editor.moveCursorHome();
+    else if (key == sf::Keyboard::End)
+        editor.moveCursorEnd();
+    else if (key == sf::Keyboard::Backspace)
+        changed = editor.backspace();
+    else if (key == sf::Keyboard::Delete)
+        changed = editor.deleteForward();
+
+    // Recompiled synchronously, so the new curve is drawn in this same frame
+    if (changed)
+        rebuildPlots();
+}
+
+void Application::handleEditorText(sf::Uint32 unicode) {
+    // Printable ASCII only; control characters are handled as key presses
+    if (unicode < 32 || unicode >= 127) return;
+
+    if (editors[selected].insert(static_cast<char>(unicode)))
+        rebuildPlots();
+}
+
+// Rebuilds the curve list and the heatmap from the last valid function of every editor
+void Application::rebuildPlots() {
+    static const sf::Color palette[] = {
+        sf::Color::Red, sf::Color::Blue, sf::Color(0, 150, 0), sf::Color(220, 120, 0), sf::Color(150, 0, 200)
+    };
+
+    functions.clear();
+    std::shared_ptr<Function> surface;
+
+    for (size_t i = 0; i < editors.size(); ++i) {
+        auto function = editors[i].getFunction();
+        if (!function) continue;
+
+        if (editors[i].usesY()) {
+            if (!surface) surface = function; // One heatmap at a time
+        }
+        else {
+            functions.emplace_back(function, palette[i % 5]);
+        }
+    }
+
+    // Only reset the heatmap tiles if its function actually changed
+    if (surface != heatmapFunction) {
+        heatmapFunction = surface;
+        heatmap.setFunction(surface);
+    }
+
+    rebuildIntegrator();
+}
+
+// Recompiles the selected plot with the other math backend; the others keep theirs
+void Application::toggleMathBackend() {
+    if (selected < 0) return;
+
+    ExpressionEditor& editor = editors[selected];
+    editor.setBackend(editor.getBackend() == MathBackend::Exact ? MathBackend::Fast : MathBackend::Exact);
+    rebuildPlots();
+}
+
+// Recreates the integrator if the first two curves changed; edits elsewhere (another
+// curve, a heatmap, an invalid keystroke) keep it and its cached panels
+void Application::rebuildIntegrator() {
+    auto upper = functions.empty() ? nullptr : functions[0].getFunction();
+    auto lower = functions.size() > 1 ? functions[1].getFunction() : nullptr;
+    if (upper == integratedUpper && lower == integratedLower) return;
+
+    integratedUpper = upper;
+    integratedLower = lower;
+    integrator.reset();
+    if (!upper) return;
+
+    integrator = std::make_unique<Integrator>(upper, lower);
+    updateArea();
+}
+
+// Re-integrates after a bound moved; the integrator only recomputes panels that changed
+void Application::updateArea() {
+    if (integrator)
+        area = integrator->integrate(areaFrom, areaTo);
+}
+
+void Application::drawArea() {
+    const UserDefinedFunction* lower = functions.size() > 1 ? &functions[1] : nullptr;
+    sf::Color color = functions[0].getColor();
+    color.a = 60;
+    renderer.drawArea(window, functions[0], lower, areaFrom, areaTo, color);
+
+    char buffer[160];
+    std::snprintf(buffer, sizeof(buffer), "Integral [%.6g, %.6g] = %.6g +/- %.2g%s",
+        areaFrom, areaTo, area.value, area.error, area.converged ? "" : " (not converged)");
+
+    areaLabel.setString(buffer);
+    areaLabel.get().setPosition(10.f, 10.f);
+    window.draw(areaLabel.get());
+}
+
+// Lists the expressions in the bottom-left corner, with the cursor and any parse error
+void Application::drawEditors() {
+    const float lineHeight = 20.f;
+    float y = window.getSize().y - 10.f - lineHeight * std::max<size_t>(editors.size(), 1);
+
+    if (editors.empty()) {
+        hintLabel.get().setPosition(10.f, y);
+        window.draw(hintLabel.get());
+        return;
+    }
+
+    while (editorLabels.size() < editors.size()) {
+        editorLabels.emplace_back(font, 14, sf::Color::Black);
+        errorLabels.emplace_back(font, 14, sf::Color::Red);
+    }
+
+    for (size_t i = 0; i < editors.size(); ++i, y += lineHeight) {
+        const ExpressionEditor& editor = editors[i];
+        bool isSelected = static_cast<int>(i) == selected;
+
+        // Built in a reused buffer; the label only re-lays out when the line changed
+        char prefix[32];
+        int prefixLength = std::snprintf(prefix, sizeof(prefix), "%s%c%d%s: ",
+            isSelected ? "> " : "  ", editor.usesY() ? 'z' : 'f', static_cast<int>(i + 1),
+            editor.getBackend() == MathBackend::Fast ? " (fast)" : "");
+
+        lineBuffer.assign(prefix);
+        lineBuffer += editor.getText();
+        if (isSelected && editing)
+            lineBuffer.insert(prefixLength + editor.getCursor(), 1, '|');
+
+        sf::Text& text = editorLabels[i].get();
+        editorLabels[i].setString(lineBuffer);
+        text.setPosition(10.f, y);
+        window.draw(text);
+
+        // The last valid version stays plotted; say why the current text isn't used
+        if (!editor.isValid() && !editor.getText().empty()) {
+            lineBuffer.assign("(");
+            lineBuffer += editor.getError();
+            lineBuffer += ')';
+
+            sf::FloatRect bounds = text.getGlobalBounds();
+            errorLabels[i].setString(lineBuffer);
+            errorLabels[i].get().setPosition(bounds.left + bounds.width + 12.f, y);
+            window.draw(errorLabels[i].get());
         }
     }
 }
 
 void Application::render() {
     window.clear(sf::Color::White);
-    renderer.draw(window, functions);
+    renderer.draw(window, functions, heatmap.hasFunction() ? &heatmap : nullptr);
+    if (showArea && integrator)
+        drawArea();
+    drawEditors();
     window.display();
 }
+
+// Prints the allocation count of a frame whenever it differs from the previous one
+void Application::reportAllocations(unsigned long long allocations) {
+    if (allocations == lastFrameAllocations) return;
+    lastFrameAllocations = allocations;
+    std::cout << "Allocations per frame: " << allocations << '\n';
+}
@@ -5,6 +5,9 @@
 #include "GraphRenderer.h"
 #include "FunctionParser.h"
 #include "UserDefinedFunction.h"
+#include "Integrator.h"
+#include "HeatmapPlot.h"
+#include "ExpressionEditor.h"
 
 class Application {
 public:
@@ -18,6 +21,46 @@ private:
 
     std::vector<UserDefinedFunction> functions;
 
+    // Expressions using y are shown as a color map instead of a curve
+    HeatmapPlot heatmap;
+    std::shared_ptr<Function> heatmapFunction;
+
+    // Source text of every plot; the curves and the heatmap are rebuilt from these
+    std::vector<ExpressionEditor> editors;
+    int selected = -1;          // Selected editor, -1 if none
+    bool editing = false;       // Keystrokes go to the selected editor
+    bool swallowText = false;   // Drop the character of the key that started editing
+
+    // Definite integral of the first curve (or between the first two), toggled with I
+    std::unique_ptr<Integrator> integrator;
+    std::shared_ptr<Function> integratedUpper;  // Functions the integrator was built for
+    std::shared_ptr<Function> integratedLower;
+    IntegrationResult area;
+    bool showArea = false;
+    float areaFrom = -1.f;
+    float areaTo = 1.f;
+    int draggedBound = -1;    // 0 = from, 1 = to, -1 = none
+
+    // Overlay text, pooled so that a steady redraw does not allocate
+    CachedText areaLabel;
+    CachedText hintLabel;
+    std::vector<CachedText> editorLabels;
+    std::vector<CachedText> errorLabels;
+    std::string lineBuffer;
+
+    // Allocations of the last rendered frame, reported when it changes (diagnostics builds)
+    unsigned long long lastFrameAllocations = 0;
+
     void processInput();
     void render();
+    void reportAllocations(unsigned long long allocations);
+    void handleEditorKey(sf::Keyboard::Key key);
+    void handleEditorText(sf::Uint32 unicode);
+    void startEditing(bool newExpression);
+    void rebuildPlots();
+    void drawEditors();
+    void rebuildIntegrator();
+    void toggleMathBackend();
+    void updateArea();
+    void drawArea();
 };
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstring>
+#include <string>
+
+// sf::Text that only re-sets its string when the content actually changes.
+// Setting a string converts it to sf::String and relays out the glyphs, both of which
+// allocate; drawing the same label every frame through this costs nothing.
+class CachedText {
+public:
+    CachedText() = default;
+    CachedText(const sf::Font& font, unsigned size, sf::Color color) {
+        text.setFont(font);
+        text.setCharacterSize(size);
+        text.setFillColor(color);
+    }
+
+    void setString(const char* s) {
+        if (valid && shown == s) return;
+        shown = s;
+        text.setString(s);
+        valid = true;
+    }
+    void setString(const std::string& s) { setString(s.c_str()); }
+
+    sf::Text& get() { return text; }
+    const sf::Text& get() const { return text; }
+
+private:
+    sf::Text text;
+    std::string shown;
+    bool valid = false; // Distinguishes an empty string from one never set
+};
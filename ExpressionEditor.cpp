@@ -0,0 +1,113 @@
+#include "ExpressionEditor.h"
+#include "ExpressionTree.h"
+#include <algorithm>
+#include <stdexcept>
+
+ExpressionEditor::ExpressionEditor(const std::string& initialText, MathBackend b)
+    : text(initialText), cursor(initialText.size()), backend(b)
+{
+    compile();
+}
+
+bool ExpressionEditor::insert(char c) {
+    replace(cursor, 0, std::string(1, c));
+    return compile();
+}
+
+bool ExpressionEditor::backspace() {
+    if (cursor == 0) return false;
+    --cursor;
+    replace(cursor, 1, "");
+    return compile();
+}
+
+bool ExpressionEditor::deleteForward() {
+    if (cursor >= text.size()) return false;
+    replace(cursor, 1, "");
+    return compile();
+}
+
+void ExpressionEditor::moveCursor(int delta) {
+    if (delta < 0) cursor -= std::min(cursor, static_cast<size_t>(-delta));
+    else cursor = std::min(text.size(), cursor + delta);
+}
+
+void ExpressionEditor::moveCursorHome() {
+    cursor = 0;
+}
+
+void ExpressionEditor::moveCursorEnd() {
+    cursor = text.size();
+}
+
+bool ExpressionEditor::setBackend(MathBackend b) {
+    backend = b;
+    compiledTokens.clear(); // Force a rebuild even though the tokens are unchanged
+    compile();
+    return valid;
+}
+
+MathBackend ExpressionEditor::getBackend() const {
+    return backend;
+}
+
+// Replaces [begin, begin + removed) with inserted text
+void ExpressionEditor::replace(size_t begin, size_t removed, const std::string& inserted) {
+    text.replace(begin, removed, inserted);
+    cursor = begin + inserted.size();
+}
+
+// Rebuilds the AST if the tokens changed; on error the previous function is kept.
+// Returns true if a new function was compiled.
+bool ExpressionEditor::compile() {
+    ExpressionParser parser;
+    std::vector<std::string> tokens = parser.tokenize(text);
+
+    // Whitespace and other edits that leave the tokens alone need no rebuild
+    if (!compiledTokens.empty() && tokens == compiledTokens) return false;
+    compiledTokens = tokens;
+
+    if (tokens.empty()) {
+        valid = false;
+        error = "Empty expression";
+        return false;
+    }
+
+    try {
+        auto ast = parser.parseTokens(tokens, backend);
+        function = std::make_shared<ExpressionTree>(text, std::move(ast));
+        functionUsesY = std::find(tokens.begin(), tokens.end(), "y") != tokens.end();
+        valid = true;
+        error.clear();
+        return true;
+    }
+    catch (const std::exception& e) {
+        valid = false;
+        error = e.what();
+        return false;
+    }
+}
+
+const std::string& ExpressionEditor::getText() const {
+    return text;
+}
+
+size_t ExpressionEditor::getCursor() const {
+    return cursor;
+}
+
+std::shared_ptr<Function> ExpressionEditor::getFunction() const {
+    return function;
+}
+
+bool ExpressionEditor::usesY() const {
+    return functionUsesY;
+}
+
+bool ExpressionEditor::isValid() const {
+    return valid;
+}
+
+const std::string& ExpressionEditor::getError() const {
+    return error;
+}
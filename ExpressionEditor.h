@@ -0,0 +1,52 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "ExpressionParser.h"
+#include "Function.h"
+
+// Editable expression text that recompiles as it is typed.
+//
+// Every edit re-tokenizes the whole text and, if the tokens changed, re-parses it; for a
+// formula of a few dozen characters that is some microseconds per keystroke. The last
+// expression that compiled stays available while the text is invalid.
+class ExpressionEditor {
+public:
+    explicit ExpressionEditor(const std::string& initialText = "", MathBackend backend = MathBackend::Exact);
+
+    // Editing at the cursor; each returns true if the compiled function changed
+    bool insert(char c);
+    bool backspace();
+    bool deleteForward();
+    void moveCursor(int delta);
+    void moveCursorHome();
+    void moveCursorEnd();
+
+    // Recompiles with another math backend; returns true if the text compiles
+    bool setBackend(MathBackend backend);
+    MathBackend getBackend() const;
+
+    const std::string& getText() const;
+    size_t getCursor() const;
+
+    // Last successfully compiled function (null if the text never compiled)
+    std::shared_ptr<Function> getFunction() const;
+    bool usesY() const;                 // Whether the compiled function is a z = f(x, y) plot
+    bool isValid() const;               // Whether the current text compiles
+    const std::string& getError() const;
+
+private:
+    std::string text;
+    size_t cursor = 0;
+    MathBackend backend;
+
+    std::vector<std::string> compiledTokens; // Tokens of the last compile attempt
+    std::shared_ptr<Function> function;
+    bool functionUsesY = false;
+    bool valid = false;
+    std::string error;
+
+    void replace(size_t begin, size_t removed, const std::string& inserted);
+    bool compile();
+};
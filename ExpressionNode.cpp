@@ -1,52 +1,241 @@
 // ExpressionNode.cpp
 #include "ExpressionNode.h"
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include <stdexcept>
 
+namespace {
+    // Math errors throw from evaluate() and give NaN from evaluateOrNaN()
+    float mathError(const char* message, bool throwOnError) {
+        if (throwOnError) throw std::runtime_error(message);
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+}
+
 // ConstantNode: holds a constant value
-float ConstantNode::evaluate(float /*x*/) const {
+float ConstantNode::evaluate(float /*x*/, float /*y*/) const {
     return value;
 }
 
-// VariableNode: returns the value of variable x
-float VariableNode::evaluate(float x) const {
-    return x;
+float ConstantNode::evaluateOrNaN(float /*x*/, float /*y*/) const {
+    return value;
+}
+
+// VariableNode: returns the value of variable x or y
+float VariableNode::evaluate(float x, float y) const {
+    return name == 'y' ? y : x;
+}
+
+float VariableNode::evaluateOrNaN(float x, float y) const {
+    return name == 'y' ? y : x;
 }
 
 // BinaryOpNode: evaluates binary operators +, -, *, /, ^
-float BinaryOpNode::evaluate(float x) const {
-    float leftVal = left->evaluate(x);
-    float rightVal = right->evaluate(x);
+float BinaryOpNode::evaluate(float x, float y) const {
+    return apply(left->evaluate(x, y), right->evaluate(x, y), true);
+}
+
+float BinaryOpNode::evaluateOrNaN(float x, float y) const {
+    return apply(left->evaluateOrNaN(x, y), right->evaluateOrNaN(x, y), false);
+}
 
+float BinaryOpNode::apply(float leftVal, float rightVal, bool throwOnError) const {
     switch (op) {
     case '+': return leftVal + rightVal;
     case '-': return leftVal - rightVal;
     case '*': return leftVal * rightVal;
     case '/':
-        if (rightVal == 0.0f) throw std::runtime_error("Division by zero");
+        if (rightVal == 0.0f) return mathError("Division by zero", throwOnError);
         return leftVal / rightVal;
-    case '^': return std::pow(leftVal, rightVal);
+    // FastMath::pow itself hands non-integer exponents to libm
+    case '^': return backend == MathBackend::Fast ? FastMath::pow(leftVal, rightVal) : std::pow(leftVal, rightVal);
     default: throw std::runtime_error("Unknown binary operator");
     }
 }
 
 // UnaryFuncNode: evaluates functions like sin, cos, etc.
-float UnaryFuncNode::evaluate(float x) const {
-    float val = operand->evaluate(x);
+float UnaryFuncNode::evaluate(float x, float y) const {
+    return apply(operand->evaluate(x, y), true);
+}
+
+float UnaryFuncNode::evaluateOrNaN(float x, float y) const {
+    return apply(operand->evaluateOrNaN(x, y), false);
+}
 
-    if (func == "sin") return std::sin(val);
-    if (func == "cos") return std::cos(val);
-    if (func == "tan") return std::tan(val);
+float UnaryFuncNode::apply(float val, bool throwOnError) const {
+    bool fast = backend == MathBackend::Fast;
+
+    if (func == "sin") return fast ? FastMath::sin(val) : std::sin(val);
+    if (func == "cos") return fast ? FastMath::cos(val) : std::cos(val);
+    if (func == "tan") return fast ? FastMath::tan(val) : std::tan(val);
+    // exp and log stay on libm in both backends: one value at a time, glibc's are faster
     if (func == "log") {
-        if (val <= 0.0f) throw std::runtime_error("log domain error");
+        if (val <= 0.0f) return mathError("log domain error", throwOnError);
         return std::log(val);
     }
     if (func == "exp") return std::exp(val);
     if (func == "sqrt") {
-        if (val < 0.0f) throw std::runtime_error("sqrt domain error");
+        if (val < 0.0f) return mathError("sqrt domain error", throwOnError);
         return std::sqrt(val);
     }
     if (func == "abs") return std::fabs(val);
 
     throw std::runtime_error("Unknown function: " + func);
 }
+
+// Interval evaluation: bounds of each node over a range of x and y.
+// A node is continuous if its operands are and the operation has no pole or domain
+// boundary inside the range; bounds that cannot be narrowed become the whole line.
+namespace {
+    const double kPi = 3.14159265358979323846;
+
+    // Carries the flags of both operands over to a result
+    Interval combine(float lo, float hi, const Interval& a, const Interval& b) {
+        Interval r(lo, hi);
+        if (std::isnan(lo) || std::isnan(hi)) r = Interval::whole(); // inf - inf, 0 * inf
+        r.continuous = a.continuous && b.continuous;
+        r.empty = a.empty || b.empty;
+        return r;
+    }
+
+    Interval multiply(const Interval& a, const Interval& b) {
+        float p[] = { a.lo * b.lo, a.lo * b.hi, a.hi * b.lo, a.hi * b.hi };
+        for (float v : p) {
+            if (std::isnan(v)) return combine(NAN, NAN, a, b);
+        }
+        return combine(*std::min_element(p, p + 4), *std::max_element(p, p + 4), a, b);
+    }
+
+    // 1 / a; a range through zero holds a pole (or is the single point 0, where it is undefined)
+    Interval reciprocal(const Interval& a) {
+        if (a.contains(0.f)) {
+            Interval r = Interval::whole();
+            r.continuous = false;
+            r.empty = a.empty || (a.lo == 0.f && a.hi == 0.f);
+            return r;
+        }
+        return combine(1.f / a.hi, 1.f / a.lo, a, a);
+    }
+
+    Interval powInteger(const Interval& base, int n) {
+        if (n == 0) return combine(1.f, 1.f, base, base);
+
+        int m = std::abs(n);
+        float lo = std::pow(base.lo, static_cast<float>(m));
+        float hi = std::pow(base.hi, static_cast<float>(m));
+        Interval r;
+        if (m % 2 == 1 || base.lo >= 0.f) r = combine(lo, hi, base, base);
+        else if (base.hi <= 0.f) r = combine(hi, lo, base, base);
+        else r = combine(0.f, std::max(lo, hi), base, base); // Even power through zero
+
+        return n < 0 ? reciprocal(r) : r;
+    }
+
+    // Whether a + k * period lies in [lo, hi] for some integer k
+    bool hitsPeriodic(double lo, double hi, double a, double period) {
+        double k = std::ceil((lo - a) / period);
+        return a + k * period <= hi;
+    }
+
+    Interval sinRange(const Interval& a) {
+        float lo = std::sin(a.lo), hi = std::sin(a.hi);
+        Interval r = combine(std::min(lo, hi), std::max(lo, hi), a, a);
+        if (!std::isfinite(a.lo) || !std::isfinite(a.hi) || a.hi - a.lo >= 2.0 * kPi) {
+            r.lo = -1.f;
+            r.hi = 1.f;
+            return r;
+        }
+        if (hitsPeriodic(a.lo, a.hi, kPi / 2, 2 * kPi)) r.hi = 1.f;
+        if (hitsPeriodic(a.lo, a.hi, -kPi / 2, 2 * kPi)) r.lo = -1.f;
+        return r;
+    }
+
+    Interval tanRange(const Interval& a) {
+        // Poles at pi/2 + k * pi; between two of them tan is increasing
+        if (!std::isfinite(a.lo) || !std::isfinite(a.hi) || a.hi - a.lo >= kPi ||
+            hitsPeriodic(a.lo, a.hi, kPi / 2, kPi)) {
+            Interval r = Interval::whole();
+            r.continuous = false;
+            r.empty = a.empty;
+            return r;
+        }
+        return combine(std::tan(a.lo), std::tan(a.hi), a, a);
+    }
+
+    // Increasing function defined for x > lower (or x >= lower when closed)
+    template <typename F>
+    Interval increasingOnDomain(const Interval& a, float lower, bool closed, F f) {
+        bool insideAll = closed ? a.lo >= lower : a.lo > lower;
+        bool insideNone = closed ? a.hi < lower : a.hi <= lower;
+
+        if (insideNone) {
+            Interval r = Interval::whole();
+            r.continuous = false;
+            r.empty = true;
+            return r;
+        }
+
+        // Only part of the range is defined: the curve starts or ends inside it
+        Interval r = combine(insideAll ? f(a.lo) : -std::numeric_limits<float>::infinity(), f(a.hi), a, a);
+        if (!insideAll) r.continuous = false;
+        return r;
+    }
+}
+
+Interval ConstantNode::evaluateInterval(const Interval& /*x*/, const Interval& /*y*/) const {
+    return Interval::point(value);
+}
+
+Interval VariableNode::evaluateInterval(const Interval& x, const Interval& y) const {
+    return name == 'y' ? y : x;
+}
+
+Interval BinaryOpNode::evaluateInterval(const Interval& x, const Interval& y) const {
+    Interval a = left->evaluateInterval(x, y);
+    Interval b = right->evaluateInterval(x, y);
+
+    switch (op) {
+    case '+': return combine(a.lo + b.lo, a.hi + b.hi, a, b);
+    case '-': return combine(a.lo - b.hi, a.hi - b.lo, a, b);
+    case '*': return multiply(a, b);
+    case '/': return multiply(a, reciprocal(b));
+    case '^': {
+        // Constant integer exponents (x^2, x^-1) are defined for negative bases too
+        if (b.lo == b.hi && std::floor(b.lo) == b.lo && std::fabs(b.lo) <= 64.f)
+            return powInteger(a, static_cast<int>(b.lo));
+
+        // Otherwise pow(a, b) = exp(b * log(a)), which needs a > 0
+        if (a.lo > 0.f) {
+            Interval logA = combine(std::log(a.lo), std::log(a.hi), a, a);
+            Interval e = multiply(b, logA);
+            return combine(std::exp(e.lo), std::exp(e.hi), e, e);
+        }
+
+        // A negative base has real powers only at isolated integer exponents, which draw nothing
+        Interval r = Interval::whole();
+        r.continuous = false;
+        r.empty = a.empty || b.empty || a.hi < 0.f;
+        return r;
+    }
+    default: throw std::runtime_error("Unknown binary operator");
+    }
+}
+
+Interval UnaryFuncNode::evaluateInterval(const Interval& x, const Interval& y) const {
+    Interval a = operand->evaluateInterval(x, y);
+
+    if (func == "sin") return sinRange(a);
+    if (func == "cos") return sinRange(combine(static_cast<float>(a.lo + kPi / 2), static_cast<float>(a.hi + kPi / 2), a, a));
+    if (func == "tan") return tanRange(a);
+    if (func == "log") return increasingOnDomain(a, 0.f, false, [](float v) { return std::log(v); });
+    if (func == "exp") return combine(std::exp(a.lo), std::exp(a.hi), a, a);
+    if (func == "sqrt") return increasingOnDomain(a, 0.f, true, [](float v) { return std::sqrt(v); });
+    if (func == "abs") {
+        if (a.lo >= 0.f) return a;
+        if (a.hi <= 0.f) return combine(-a.hi, -a.lo, a, a);
+        return combine(0.f, std::max(-a.lo, a.hi), a, a);
+    }
+
+    throw std::runtime_error("Unknown function: " + func);
+}
@@ -2,39 +2,64 @@
 #pragma once
 #include <memory>
 #include <string>
+#include "FastMath.h"
+#include "Interval.h"
 
 class ExpressionNode {
 public:
     virtual ~ExpressionNode() = default;
-    virtual float evaluate(float x) const = 0;
+    float evaluate(float x) const { return evaluate(x, 0.f); }
+    virtual float evaluate(float x, float y) const = 0;
+    // Same value, but math errors (log(-1), division by zero, ...) give NaN instead of throwing
+    virtual float evaluateOrNaN(float x, float y) const = 0;
+
+    // Bounds of the expression while x and y range over the given intervals.
+    // Uses exact math regardless of the backend; only the shape of the function matters.
+    Interval evaluateInterval(const Interval& x) const { return evaluateInterval(x, Interval::point(0.f)); }
+    virtual Interval evaluateInterval(const Interval& x, const Interval& y) const = 0;
 };
 
 class ConstantNode : public ExpressionNode {
     float value;
 public:
     ConstantNode(float val) : value(val) {}
-    float evaluate(float x) const override;
+    float evaluate(float x, float y) const override;
+    float evaluateOrNaN(float x, float y) const override;
+    Interval evaluateInterval(const Interval& x, const Interval& y) const override;
 };
 
 class VariableNode : public ExpressionNode {
+    char name; // 'x' or 'y'
 public:
-    float evaluate(float x) const override;
+    VariableNode(char n = 'x') : name(n) {}
+    float evaluate(float x, float y) const override;
+    float evaluateOrNaN(float x, float y) const override;
+    Interval evaluateInterval(const Interval& x, const Interval& y) const override;
 };
 
 class BinaryOpNode : public ExpressionNode {
     char op;
     std::unique_ptr<ExpressionNode> left, right;
+    MathBackend backend;
+    float apply(float leftVal, float rightVal, bool throwOnError) const;
 public:
-    BinaryOpNode(char o, std::unique_ptr<ExpressionNode> l, std::unique_ptr<ExpressionNode> r)
-        : op(o), left(std::move(l)), right(std::move(r)) {}
-    float evaluate(float x) const override;
+    BinaryOpNode(char o, std::unique_ptr<ExpressionNode> l, std::unique_ptr<ExpressionNode> r,
+        MathBackend b = MathBackend::Exact)
+        : op(o), left(std::move(l)), right(std::move(r)), backend(b) {}
+    float evaluate(float x, float y) const override;
+    float evaluateOrNaN(float x, float y) const override;
+    Interval evaluateInterval(const Interval& x, const Interval& y) const override;
 };
 
 class UnaryFuncNode : public ExpressionNode {
     std::string func;
     std::unique_ptr<ExpressionNode> operand;
+    MathBackend backend;
+    float apply(float val, bool throwOnError) const;
 public:
-    UnaryFuncNode(const std::string& f, std::unique_ptr<ExpressionNode> op)
-        : func(f), operand(std::move(op)) {}
-    float evaluate(float x) const override;
+    UnaryFuncNode(const std::string& f, std::unique_ptr<ExpressionNode> op, MathBackend b = MathBackend::Exact)
+        : func(f), operand(std::move(op)), backend(b) {}
+    float evaluate(float x, float y) const override;
+    float evaluateOrNaN(float x, float y) const override;
+    Interval evaluateInterval(const Interval& x, const Interval& y) const override;
 };
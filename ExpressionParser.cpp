@@ -34,6 +34,11 @@ bool ExpressionParser::isFunction(const std::string& token) {
     return funcs.count(token);
 }
 
+// Returns true if a token is a variable (x, or y for two-variable plots).
+bool ExpressionParser::isVariable(const std::string& token) {
+    return token == "x" || token == "y";
+}
+
 // Returns true if a token is a valid number (float).
 bool ExpressionParser::isNumber(const std::string& token) {
     if (token.empty()) return false;
@@ -42,46 +47,54 @@ bool ExpressionParser::isNumber(const std::string& token) {
     return *end == '\0';
 }
 
-// Converts a raw expression string into a list of tokens (numbers, operators, variables, functions, etc.)
-std::vector<std::string> ExpressionParser::tokenize(const std::string& expr) {
-    std::vector<std::string> tokens;
-    std::string curr;
+// Reads the next token (number, operator, variable, function, parenthesis) at or after pos
+// and moves pos just past it. Returns false when only whitespace remains.
+bool ExpressionParser::nextToken(const std::string& expr, size_t& pos, std::string& token) {
+    while (pos < expr.size()) {
+        char c = expr[pos];
+
+        // Skip whitespace
+        if (std::isspace(c)) {
+            ++pos;
+            continue;
+        }
 
-    for (size_t i = 0; i < expr.size(); ++i) {
-        char c = expr[i];
-        if (std::isspace(c)) continue;
+        token.clear();
 
-        // Number or decimal point
+        // Number or decimal point; whitespace inside a number is skipped, so "1 000" reads as 1000
         if (std::isdigit(c) || c == '.') {
-            curr += c;
+            for (size_t i = pos; i < expr.size() && (std::isdigit(expr[i]) || expr[i] == '.' || std::isspace(expr[i])); ++i) {
+                if (std::isspace(expr[i])) continue;
+                token += expr[i];
+                pos = i + 1;
+            }
+        }
+        // Function or variable name
+        else if (std::isalpha(c)) {
+            while (pos < expr.size() && std::isalpha(expr[pos])) token += expr[pos++];
         }
+        // Operator, parenthesis, or a character the grammar doesn't know; the latter
+        // becomes a token of its own so that parsing reports it instead of skipping it
         else {
-            // Push current number token
-            if (!curr.empty()) {
-                tokens.push_back(curr);
-                curr.clear();
-            }
-
-            // Function or variable name
-            if (std::isalpha(c)) {
-                std::string func;
-                while (i < expr.size() && std::isalpha(expr[i])) func += expr[i++];
-                --i;
-                tokens.push_back(func);
-            }
-            // Operator or parentheses
-            else if (c == '(' || c == ')' || isOperator(std::string(1, c))) {
-                tokens.push_back(std::string(1, c));
-            }
-            // Variable 'x'
-            else if (c == 'x') {
-                tokens.push_back("x");
-            }
+            token = std::string(1, c);
+            ++pos;
         }
+
+        return true;
     }
 
-    // Push the final token if any
-    if (!curr.empty()) tokens.push_back(curr);
+    return false;
+}
+
+// Converts a raw expression string into a list of tokens (numbers, operators, variables, functions, etc.)
+std::vector<std::string> ExpressionParser::tokenize(const std::string& expr) {
+    std::vector<std::string> tokens;
+    size_t pos = 0;
+    std::string token;
+
+    while (nextToken(expr, pos, token))
+        tokens.push_back(token);
+
     return tokens;
 }
 
@@ -91,7 +104,7 @@ std::vector<std::string> ExpressionParser::toRPN(const std::vector<std::string>&
     std::stack<std::string> ops;
 
     for (const std::string& token : tokens) {
-        if (isNumber(token) || token == "x") {
+        if (isNumber(token) || isVariable(token)) {
             // Operand: directly add to output
             output.push_back(token);
         }
@@ -133,6 +146,10 @@ std::vector<std::string> ExpressionParser::toRPN(const std::vector<std::string>&
                 ops.pop();
             }
         }
+        else {
+            // Unknown names (e.g. "si" halfway through typing "sin") must not be silently dropped
+            throw std::runtime_error("Unknown token: " + token);
+        }
     }
 
     // Pop any remaining operators
@@ -148,26 +165,27 @@ std::vector<std::string> ExpressionParser::toRPN(const std::vector<std::string>&
 }
 
 // Builds an abstract syntax tree (AST) from postfix (RPN) tokens.
-std::unique_ptr<ExpressionNode> ExpressionParser::buildAST(const std::vector<std::string>& rpn) {
+// Function and power nodes are compiled against the requested math backend.
+std::unique_ptr<ExpressionNode> ExpressionParser::buildAST(const std::vector<std::string>& rpn, MathBackend backend) {
     std::stack<std::unique_ptr<ExpressionNode>> stk;
 
     for (const std::string& token : rpn) {
         if (isNumber(token)) {
             stk.push(std::make_unique<ConstantNode>(std::stof(token)));
         }
-        else if (token == "x") {
-            stk.push(std::make_unique<VariableNode>());
+        else if (isVariable(token)) {
+            stk.push(std::make_unique<VariableNode>(token[0]));
         }
         else if (isOperator(token)) {
             if (stk.size() < 2) throw std::runtime_error("Missing operand for operator");
             auto right = std::move(stk.top()); stk.pop();
             auto left = std::move(stk.top()); stk.pop();
-            stk.push(std::make_unique<BinaryOpNode>(token[0], std::move(left), std::move(right)));
+            stk.push(std::make_unique<BinaryOpNode>(token[0], std::move(left), std::move(right), backend));
         }
         else if (isFunction(token)) {
             if (stk.empty()) throw std::runtime_error("Missing operand for function");
             auto operand = std::move(stk.top()); stk.pop();
-            stk.push(std::make_unique<UnaryFuncNode>(token, std::move(operand)));
+            stk.push(std::make_unique<UnaryFuncNode>(token, std::move(operand), backend));
         }
     }
 
@@ -176,8 +194,12 @@ std::unique_ptr<ExpressionNode> ExpressionParser::buildAST(const std::vector<std
 }
 
 // Parses a string expression into an ExpressionNode tree (AST).
-std::unique_ptr<ExpressionNode> ExpressionParser::parse(const std::string& expression) {
-    auto tokens = tokenize(expression);
+std::unique_ptr<ExpressionNode> ExpressionParser::parse(const std::string& expression, MathBackend backend) {
+    return parseTokens(tokenize(expression), backend);
+}
+
+// Builds an AST from an already tokenized expression (used by the editor).
+std::unique_ptr<ExpressionNode> ExpressionParser::parseTokens(const std::vector<std::string>& tokens, MathBackend backend) {
     auto rpn = toRPN(tokens);
-    return buildAST(rpn);
+    return buildAST(rpn, backend);
 }
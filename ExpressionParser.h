@@ -5,11 +5,14 @@
 #include <queue>
 #include <sstream>
 #include <map>
+#include <vector>
 #include "ExpressionNode.h"
 
 class ExpressionParser {
 public:
-    std::unique_ptr<ExpressionNode> parse(const std::string& expression);
+    std::unique_ptr<ExpressionNode> parse(const std::string& expression, MathBackend backend = MathBackend::Exact);
+    std::unique_ptr<ExpressionNode> parseTokens(const std::vector<std::string>& tokens, MathBackend backend = MathBackend::Exact);
+    std::vector<std::string> tokenize(const std::string& expr);
 
 private:
     int getPrecedence(const std::string& op);
@@ -17,7 +20,8 @@ private:
     bool isOperator(const std::string& token);
     bool isFunction(const std::string& token);
     bool isNumber(const std::string& token);
-    std::vector<std::string> tokenize(const std::string& expr);
+    bool isVariable(const std::string& token);
+    bool nextToken(const std::string& expr, size_t& pos, std::string& token);
     std::vector<std::string> toRPN(const std::vector<std::string>& tokens);
-    std::unique_ptr<ExpressionNode> buildAST(const std::vector<std::string>& rpn);
+    std::unique_ptr<ExpressionNode> buildAST(const std::vector<std::string>& rpn, MathBackend backend);
 };
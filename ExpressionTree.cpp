@@ -3,17 +3,38 @@
 
 
 
-ExpressionTree::ExpressionTree(const std::string& expression)
+ExpressionTree::ExpressionTree(const std::string& expression, MathBackend backend)
     : expr(expression) 
 {
     ExpressionParser parser;
-    root = parser.parse(expression); // convert expression into AST tree
+    root = parser.parse(expression, backend); // convert expression into AST tree
+}
+
+ExpressionTree::ExpressionTree(const std::string& expression, std::unique_ptr<ExpressionNode> ast)
+    : expr(expression), root(std::move(ast))
+{
 }
 
 float ExpressionTree::evaluate(float x) const {
     return root->evaluate(x); // using evaluate of AST tree
 }
 
+float ExpressionTree::evaluate(float x, float y) const {
+    return root->evaluate(x, y);
+}
+
+float ExpressionTree::evaluateOrNaN(float x) const {
+    return root->evaluateOrNaN(x, 0.f);
+}
+
+float ExpressionTree::evaluateOrNaN(float x, float y) const {
+    return root->evaluateOrNaN(x, y);
+}
+
+Interval ExpressionTree::evaluateInterval(float x0, float x1) const {
+    return root->evaluateInterval(Interval(x0, x1));
+}
+
 // Simple evaluator test
 //float ExpressionTree::evaluate(float x) const {
 //    return simpleEval(expr, x);
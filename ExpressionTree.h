@@ -9,8 +9,13 @@
 
 class ExpressionTree : public Function {
 public:
-    ExpressionTree(const std::string& expression);
+    ExpressionTree(const std::string& expression, MathBackend backend = MathBackend::Exact);
+    ExpressionTree(const std::string& expression, std::unique_ptr<ExpressionNode> ast); // Already parsed
     float evaluate(float x) const;
+    float evaluate(float x, float y) const override;
+    float evaluateOrNaN(float x) const override;
+    float evaluateOrNaN(float x, float y) const override;
+    Interval evaluateInterval(float x0, float x1) const override;
 
     //float evaluate(float x) const override;
 
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Which implementation of the elementary functions an expression is compiled with
+enum class MathBackend {
+    Exact,  // libm (std::sin, std::exp, ...)
+    Fast    // FastMath sin, cos, tan and integer powers; libm for the rest
+};
+
+// Approximate float kernels for plotting, where a relative error of ~1e-5 is far below
+// one pixel. Each kernel is a range reduction plus a short minimax polynomial with no
+// table lookups.
+//
+// The scalar forms branch to libm for arguments outside the polynomial's domain, which
+// keeps a loop calling them from being vectorized. The array forms (sin(in, out, n), ...)
+// run the branch-free core over every element, with out-of-domain arguments masked to a
+// harmless value, then patch those elements with the scalar form in a second pass; the
+// first pass vectorizes (GCC -O3: "loop vectorized using 32 byte vectors" with AVX2).
+//
+// Expressions evaluate one sample at a time, so MathBackend::Fast only uses the scalar
+// kernels that beat glibc in `GraphPlotter --bench-fastmath` (GCC -O2): sin, cos, tan and
+// integer powers. The scalar exp and log are slower than glibc's expf and logf and only
+// pay off in the array forms.
+//
+// Maximum error against a double-precision libm reference, measured with
+// `GraphPlotter --check-fastmath 1` over every float in the stated domain (about 45 minutes;
+// the default stride of 16 checks every 16th float):
+//   sin, cos   |x| <= 1.6e6          2 ULP   (larger |x| falls back to libm)
+//   tan        |x| <= 1.6e6          4 ULP   (away from the poles, where tan is ill-conditioned)
+//   exp        all x                 2 ULP   (results below FLT_MIN fall back to libm)
+//   log        x > 0                 2 ULP
+//   pow        integer |y| <= 64     1 ULP   (repeated squaring in double, any sign of x;
+//                                            other exponents fall back to libm)
+namespace FastMath {
+
+namespace detail {
+
+inline std::uint32_t toBits(float x) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+inline float fromBits(std::uint32_t bits) {
+    float x;
+    std::memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+// a where mask is all ones, b where it is zero. Selecting on integer masks rather than
+// with ?: on floats lets compilers if-convert (and so vectorize) without fast-math flags.
+inline float blend(std::uint32_t mask, float a, float b) {
+    return fromBits((toBits(a) & mask) | (toBits(b) & ~mask));
+}
+
+inline std::uint32_t maskIf(bool condition) {
+    return 0u - static_cast<std::uint32_t>(condition);
+}
+
+// Largest |x| reduced here; k * kPio2Hi stays exact while k < 2^20
+const float kMaxTrigArgument = 1.6e6f;
+
+// pi/2 split into a 33-bit head and its tail (Cody-Waite)
+const double kPio2Hi = 1.57079632673412561417e+00;
+const double kPio2Lo = 6.07710050650619224932e-11;
+const double kTwoOverPi = 6.36619772367581382433e-01;
+
+// Round to nearest by adding and removing 1.5 * 2^52; avoids a
+// nearbyint() library call on targets without a rounding instruction
+inline double roundNearest(double x) {
+    const double shifter = 6755399441055744.0;
+    return (x + shifter) - shifter;
+}
+
+// Reduces x to r in [-pi/4, pi/4] and returns the quadrant k (x = r + k * pi/2)
+inline int reduce(float x, float& r) {
+    double k = roundNearest(static_cast<double>(x) * kTwoOverPi);
+    r = static_cast<float>((static_cast<double>(x) - k * kPio2Hi) - k * kPio2Lo);
+    return static_cast<int>(k);
+}
+
+// Minimax polynomials on [-pi/4, pi/4] (Cephes)
+inline float sinPoly(float r) {
+    float z = r * r;
+    return r + r * z * (-1.6666654611e-1f + z * (8.3321608736e-3f + z * -1.9515295891e-4f));
+}
+
+inline float cosPoly(float r) {
+    float z = r * r;
+    return 1.f - 0.5f * z + z * z * (4.166664568298827e-2f + z * (-1.388731625493765e-3f + z * 2.443315711809948e-5f));
+}
+
+// Splits a positive normal x into m * 2^e with m in [sqrt(1/2), sqrt(2)) and returns log(m)
+inline float logMantissa(float x, int& e) {
+    std::uint32_t bits = toBits(x);
+    e = static_cast<int>((bits >> 23) & 0xff) - 126;
+    float m = fromBits((bits & 0x007fffff) | 0x3f000000); // [0.5, 1)
+
+    // Branch-free: below sqrt(1/2), double m and take one off the exponent
+    int small = m < 0.707106781186547524f;
+    e -= small;
+    m = (m + m * static_cast<float>(small)) - 1.f; // Arithmetic, so compilers don't emit a branch
+
+    // Cephes polynomial, evaluated in Estrin form to shorten the dependency chain
+    float z = m * m;
+    float z2 = z * z;
+    float z4 = z2 * z2;
+    float p01 = 3.3333331174e-1f - 2.4999993993e-1f * m;
+    float p23 = 2.0000714765e-1f - 1.6668057665e-1f * m;
+    float p45 = 1.4249322787e-1f - 1.2420140846e-1f * m;
+    float p67 = 1.1676998740e-1f - 1.1514610310e-1f * m;
+    float p = (p01 + z * p23) + z2 * (p45 + z * p67) + z4 * 7.0376836292e-2f;
+    float y = p * m * z;
+    return m + (y - 0.5f * z);
+}
+
+// exp(x) for x in [-87.34, 88.72]
+inline float expCore(float x) {
+    // x = n * ln2 + r with |r| <= ln2 / 2, reduced in double so r keeps full precision
+    double n = roundNearest(static_cast<double>(x) * 1.44269504088896341);
+    float r = static_cast<float>(static_cast<double>(x) - n * 0.693147180559945309);
+
+    float z = r * r;
+    float p = ((((( 1.9875691500e-4f * r + 1.3981999507e-3f) * r + 8.3334519073e-3f) * r
+        + 4.1665795894e-2f) * r + 1.6666665459e-1f) * r + 5.0000001201e-1f) * z + r + 1.f;
+
+    // Multiply by 2^n through the exponent bits; n is in [-126, 128], so split it in two
+    int e = static_cast<int>(n);
+    int half = e / 2;
+    float scaleA = fromBits(static_cast<std::uint32_t>(half + 127) << 23);
+    float scaleB = fromBits(static_cast<std::uint32_t>(e - half + 127) << 23);
+    return p * scaleA * scaleB;
+}
+
+// Domains of the polynomial cores, tested on the bit patterns (NaN is outside all of them)
+inline bool trigInDomain(float x) {
+    return (toBits(x) & 0x7fffffffu) <= toBits(kMaxTrigArgument);
+}
+
+inline bool expInDomain(float x) {
+    std::uint32_t bits = toBits(x);
+    return bits <= ((bits >> 31) ? toBits(-87.3365479f) : toBits(88.7228394f));
+}
+
+inline bool logInDomain(float x) {
+    return toBits(x) - 0x00800000u < 0x7f000000u; // Positive, normal and finite
+}
+
+// Branch-free cores, valid inside the domains above. Both polynomials are evaluated and
+// selected: the quadrant of consecutive samples is unpredictable, and a mispredict costs
+// more than a polynomial.
+inline float sinCore(float x) {
+    float r;
+    int k = reduce(x, r);
+    float v = blend(maskIf(k & 1), cosPoly(r), sinPoly(r));
+    return fromBits(toBits(v) ^ (static_cast<std::uint32_t>(k & 2) << 30));
+}
+
+inline float cosCore(float x) {
+    float r;
+    int k = reduce(x, r);
+    float v = blend(maskIf(k & 1), sinPoly(r), cosPoly(r));
+    return fromBits(toBits(v) ^ (static_cast<std::uint32_t>((k + 1) & 2) << 30));
+}
+
+inline float tanCore(float x) {
+    float r;
+    int k = reduce(x, r);
+    float s = sinPoly(r);
+    float c = cosPoly(r);
+    std::uint32_t odd = maskIf(k & 1);
+    return blend(odd, -c, s) / blend(odd, s, c);
+}
+
+inline float logCore(float x) {
+    int e;
+    float logm = logMantissa(x, e);
+    float fe = static_cast<float>(e);
+    return (logm + -2.12194440e-4f * fe) + 0.693359375f * fe;
+}
+
+// Applies core to every element with out-of-domain arguments replaced by safe, then
+// recomputes those elements with the scalar kernel. in and out must not overlap.
+template <typename InDomain, typename Core, typename Scalar>
+inline void apply(const float* in, float* out, std::size_t n, float safe, InDomain inDomain, Core core, Scalar scalar) {
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = core(blend(maskIf(inDomain(in[i])), in[i], safe));
+    for (std::size_t i = 0; i < n; ++i) {
+        if (!inDomain(in[i])) out[i] = scalar(in[i]);
+    }
+}
+
+}
+
+inline float sin(float x) {
+    if (!detail::trigInDomain(x)) return std::sin(x); // Huge, inf or NaN
+    return detail::sinCore(x);
+}
+
+inline float cos(float x) {
+    if (!detail::trigInDomain(x)) return std::cos(x);
+    return detail::cosCore(x);
+}
+
+inline float tan(float x) {
+    if (!detail::trigInDomain(x)) return std::tan(x);
+    return detail::tanCore(x);
+}
+
+inline float exp(float x) {
+    if (x > 88.7228394f) return INFINITY;
+    if (x < -87.3365479f) return std::exp(x); // Subnormal or zero result
+    if (x != x) return x;
+    return detail::expCore(x);
+}
+
+inline float log(float x) {
+    if (!detail::logInDomain(x)) return std::log(x); // <= 0, subnormal, inf or NaN
+    return detail::logCore(x);
+}
+
+inline float pow(float x, float y) {
+    // Small integer exponents by repeated squaring, valid for negative x. Done in double:
+    // in float each squaring doubles the relative error, reaching 3e-6 at y = 64.
+    if (std::fabs(y) <= 64.f && static_cast<float>(static_cast<int>(y)) == y) {
+        int n = static_cast<int>(std::fabs(y));
+        double base = x, result = 1.0;
+        while (n) {
+            if (n & 1) result *= base;
+            base *= base;
+            n >>= 1;
+        }
+        return static_cast<float>(y < 0.f ? 1.0 / result : result);
+    }
+
+    // Other exponents need exp(y * log(x)) carried in double to stay within 2e-6 (an error
+    // in log(x) is multiplied by y), and that loses to glibc's powf
+    return std::pow(x, y);
+}
+
+// Array forms: out[i] = f(in[i]) for i < n, identical to the scalar kernels element by element
+inline void sin(const float* in, float* out, std::size_t n) {
+    detail::apply(in, out, n, 0.f, detail::trigInDomain, detail::sinCore, [](float x) { return sin(x); });
+}
+
+inline void cos(const float* in, float* out, std::size_t n) {
+    detail::apply(in, out, n, 0.f, detail::trigInDomain, detail::cosCore, [](float x) { return cos(x); });
+}
+
+inline void tan(const float* in, float* out, std::size_t n) {
+    detail::apply(in, out, n, 0.f, detail::trigInDomain, detail::tanCore, [](float x) { return tan(x); });
+}
+
+inline void exp(const float* in, float* out, std::size_t n) {
+    detail::apply(in, out, n, 0.f, detail::expInDomain, detail::expCore, [](float x) { return exp(x); });
+}
+
+inline void log(const float* in, float* out, std::size_t n) {
+    detail::apply(in, out, n, 1.f, detail::logInDomain, detail::logCore, [](float x) { return log(x); });
+}
+
+}
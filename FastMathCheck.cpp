@@ -0,0 +1,280 @@
+#include "FastMathCheck.h"
+#include "FastMath.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct KernelStats {
+    const char* name;
+    double maxUlp = 0.0;
+    float worstInput = 0.f;
+    std::uint64_t checked = 0;
+    std::uint64_t mismatches = 0; // Fast and reference disagree on inf/NaN
+};
+
+// Distance between the fast result and the exact value, in units of the float spacing at the exact value
+double ulpError(float fast, double reference) {
+    float rounded = static_cast<float>(reference);
+    double spacing = static_cast<double>(std::nextafter(std::fabs(rounded), INFINITY)) - std::fabs(rounded);
+    return std::fabs(static_cast<double>(fast) - reference) / spacing;
+}
+
+// Compares one kernel to its double-precision libm counterpart over every stride-th float in [lo, hi]
+template <typename Fast, typename Exact, typename Skip>
+KernelStats sweep(const char* name, float lo, float hi, unsigned stride, Fast fast, Exact exact, Skip skip) {
+    KernelStats stats;
+    stats.name = name;
+
+    // Walk the bit patterns of negative and positive floats separately so the order is monotonic
+    auto visit = [&](float x) {
+        if (x < lo || x > hi) return;
+        double reference = exact(static_cast<double>(x));
+        if (skip(x, reference)) return;
+        if (std::fabs(reference) > FLT_MAX) reference = std::copysign(INFINITY, reference); // Overflows as a float
+
+        float result = fast(x);
+        ++stats.checked;
+
+        if (!std::isfinite(reference) || std::fabs(reference) < FLT_MIN) {
+            bool agree = (std::isnan(reference) && std::isnan(result)) ||
+                (std::isinf(reference) && result == static_cast<float>(reference)) ||
+                (std::fabs(reference) < FLT_MIN && std::fabs(result) < FLT_MIN * 2.f);
+            if (!agree) ++stats.mismatches;
+            return;
+        }
+
+        double error = ulpError(result, reference);
+        if (!(error <= stats.maxUlp)) {
+            stats.maxUlp = error;
+            stats.worstInput = x;
+        }
+    };
+
+    for (std::uint64_t bits = 0; bits < 0x7f800000u; bits += stride) {
+        float x = FastMath::detail::fromBits(static_cast<std::uint32_t>(bits));
+        visit(x);
+        visit(-x);
+    }
+    return stats;
+}
+
+bool report(const KernelStats& stats, double ulpLimit) {
+    bool ok = stats.maxUlp <= ulpLimit && stats.mismatches == 0;
+    std::printf("%-5s %12llu inputs  max %8.3f ULP (limit %g) at x = %.9g  %llu special-value mismatches  %s\n",
+        stats.name, static_cast<unsigned long long>(stats.checked), stats.maxUlp, ulpLimit, stats.worstInput,
+        static_cast<unsigned long long>(stats.mismatches), ok ? "OK" : "FAIL");
+    return ok;
+}
+
+auto never = [](float, double) { return false; };
+
+// Runs the array form over every stride-th float of both signs, in chunks, and counts elements
+// whose bits differ from the scalar kernel (the two must agree exactly, NaNs included)
+template <typename Scalar, typename Batch>
+bool checkBatch(const char* name, unsigned stride, Scalar scalar, Batch batch) {
+    const size_t chunk = 4096;
+    std::vector<float> in, out(chunk);
+    in.reserve(chunk);
+    std::uint64_t checked = 0, differences = 0;
+
+    auto flush = [&]() {
+        batch(in.data(), out.data(), in.size());
+        for (size_t i = 0; i < in.size(); ++i) {
+            float expected = scalar(in[i]);
+            bool same = FastMath::detail::toBits(out[i]) == FastMath::detail::toBits(expected) ||
+                (std::isnan(out[i]) && std::isnan(expected));
+            if (!same) ++differences;
+        }
+        checked += in.size();
+        in.clear();
+    };
+
+    for (std::uint64_t bits = 0; bits <= 0x7fffffffu; bits += stride) {
+        float x = FastMath::detail::fromBits(static_cast<std::uint32_t>(bits));
+        in.push_back(x);
+        in.push_back(-x);
+        if (in.size() >= chunk) flush();
+    }
+    flush();
+
+    bool ok = differences == 0;
+    std::printf("%-5s %12llu inputs  array form differs from scalar on %llu  %s\n", name,
+        static_cast<unsigned long long>(checked), static_cast<unsigned long long>(differences), ok ? "OK" : "FAIL");
+    return ok;
+}
+
+struct PowStats {
+    double maxRelative = 0.0;
+    float worstX = 0.f, worstY = 0.f;
+    int checked = 0;
+};
+
+// Samples pow(x, y) against double pow over pairs drawn by next(), skipping results
+// that are not normal floats
+template <typename Next>
+PowStats samplePow(int samples, Next next) {
+    PowStats stats;
+    for (int i = 0; i < samples; ++i) {
+        float x, y;
+        next(x, y);
+        double reference = std::pow(static_cast<double>(x), static_cast<double>(y));
+        if (!(std::fabs(reference) >= FLT_MIN && std::fabs(reference) <= FLT_MAX)) continue;
+
+        ++stats.checked;
+        double relative = std::fabs(FastMath::pow(x, y) - reference) / std::fabs(reference);
+        if (!(relative <= stats.maxRelative)) {
+            stats.maxRelative = relative;
+            stats.worstX = x;
+            stats.worstY = y;
+        }
+    }
+    return stats;
+}
+
+bool reportPow(const char* range, const PowStats& stats, double limit) {
+    bool ok = stats.maxRelative <= limit;
+    std::printf("pow   %12d inputs  %-24s max relative error %.3g (limit %.3g) at x = %.9g, y = %.9g  %s\n",
+        stats.checked, range, stats.maxRelative, limit, stats.worstX, stats.worstY, ok ? "OK" : "FAIL");
+    return ok;
+}
+
+}
+
+int runFastMathCheck(unsigned stride) {
+    if (stride == 0) stride = 1;
+    if (stride == 1) std::printf("Checking FastMath kernels against libm on every float\n");
+    else std::printf("Checking FastMath kernels against libm on every %u-th float\n", stride);
+
+    const float trigRange = FastMath::detail::kMaxTrigArgument;
+    bool ok = true;
+
+    ok &= report(sweep("sin", -trigRange, trigRange, stride,
+        [](float x) { return FastMath::sin(x); }, [](double x) { return std::sin(x); }, never), 2.0);
+    ok &= report(sweep("cos", -trigRange, trigRange, stride,
+        [](float x) { return FastMath::cos(x); }, [](double x) { return std::cos(x); }, never), 2.0);
+    // Near a pole the float input itself is uncertain by more than the result range, so skip |tan| > 1e4
+    ok &= report(sweep("tan", -trigRange, trigRange, stride,
+        [](float x) { return FastMath::tan(x); }, [](double x) { return std::tan(x); },
+        [](float, double r) { return std::fabs(r) > 1e4; }), 4.0);
+    ok &= report(sweep("exp", -FLT_MAX, FLT_MAX, stride,
+        [](float x) { return FastMath::exp(x); }, [](double x) { return std::exp(x); }, never), 2.0);
+    ok &= report(sweep("log", FLT_MIN, FLT_MAX, stride,
+        [](float x) { return FastMath::log(x); }, [](double x) { return std::log(x); }, never), 2.0);
+
+    // pow has two arguments: sample pairs instead of sweeping, and report relative error.
+    // x is drawn over the whole float range of either sign; only integer exponents have
+    // their own kernel, the rest go to libm.
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    std::uniform_int_distribution<int> smallInteger(-64, 64);
+    const int powSamples = 20000000 / static_cast<int>(stride < 64 ? 1 : stride / 64);
+    auto anyPositive = [&]() { return std::exp2(unit(rng) * 252.f - 126.f); };
+
+    // Integer exponents up to 64: repeated squaring, any sign of x
+    ok &= reportPow("integer |y| <= 64", samplePow(powSamples, [&](float& x, float& y) {
+        y = static_cast<float>(smallInteger(rng));
+        x = anyPositive();
+        if (unit(rng) < 0.5f) x = -x;
+    }), 2.0 * FLT_EPSILON / 2);
+
+    // The array forms must match the scalar kernels exactly
+    ok &= checkBatch("sin", stride, [](float x) { return FastMath::sin(x); },
+        [](const float* in, float* out, size_t n) { FastMath::sin(in, out, n); });
+    ok &= checkBatch("cos", stride, [](float x) { return FastMath::cos(x); },
+        [](const float* in, float* out, size_t n) { FastMath::cos(in, out, n); });
+    ok &= checkBatch("tan", stride, [](float x) { return FastMath::tan(x); },
+        [](const float* in, float* out, size_t n) { FastMath::tan(in, out, n); });
+    ok &= checkBatch("exp", stride, [](float x) { return FastMath::exp(x); },
+        [](const float* in, float* out, size_t n) { FastMath::exp(in, out, n); });
+    ok &= checkBatch("log", stride, [](float x) { return FastMath::log(x); },
+        [](const float* in, float* out, size_t n) { FastMath::log(in, out, n); });
+
+    return ok ? 0 : 1;
+}
+
+int runFastMathBenchmark() {
+    const size_t count = 1 << 20;
+    const int repeats = 20;
+
+    std::vector<float> trigInput(count), expInput(count), logInput(count), powBase(count), powExponent(count), output(count);
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> trig(-100.f, 100.f), expo(-80.f, 80.f), logs(1e-6f, 1e6f), bases(-10.f, 10.f);
+    for (size_t i = 0; i < count; ++i) {
+        trigInput[i] = trig(rng);
+        expInput[i] = expo(rng);
+        logInput[i] = logs(rng);
+        powBase[i] = bases(rng);
+    }
+
+    // Runs kernel over the input array and returns millions of evaluations per second
+    auto measure = [&](const std::vector<float>& input, auto kernel) {
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeats; ++r)
+            for (size_t i = 0; i < count; ++i)
+                output[i] = kernel(input[i]);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return count * repeats / seconds / 1e6;
+    };
+
+    // Same for an array form, called once per repeat over the whole input
+    auto measureArray = [&](const std::vector<float>& input, auto kernel) {
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeats; ++r)
+            kernel(input.data(), output.data(), count);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return count * repeats / seconds / 1e6;
+    };
+
+    // Expressions call the scalar kernels one sample at a time; only batch callers get the array forms
+    std::printf("%-6s %12s %12s %12s %13s %13s\n", "kernel", "exact M/s", "scalar M/s", "array M/s", "scalar/exact", "array/exact");
+
+    auto row = [&](const char* name, const std::vector<float>& input, auto exact, auto fast, auto array) {
+        double e = measure(input, exact);
+        double f = measure(input, fast);
+        double a = measureArray(input, array);
+        std::printf("%-6s %12.1f %12.1f %12.1f %12.2fx %12.2fx\n", name, e, f, a, f / e, a / e);
+    };
+
+    row("sin", trigInput, [](float x) { return std::sin(x); }, [](float x) { return FastMath::sin(x); },
+        [](const float* in, float* out, size_t n) { FastMath::sin(in, out, n); });
+    row("cos", trigInput, [](float x) { return std::cos(x); }, [](float x) { return FastMath::cos(x); },
+        [](const float* in, float* out, size_t n) { FastMath::cos(in, out, n); });
+    row("tan", trigInput, [](float x) { return std::tan(x); }, [](float x) { return FastMath::tan(x); },
+        [](const float* in, float* out, size_t n) { FastMath::tan(in, out, n); });
+    row("exp", expInput, [](float x) { return std::exp(x); }, [](float x) { return FastMath::exp(x); },
+        [](const float* in, float* out, size_t n) { FastMath::exp(in, out, n); });
+    row("log", logInput, [](float x) { return std::log(x); }, [](float x) { return FastMath::log(x); },
+        [](const float* in, float* out, size_t n) { FastMath::log(in, out, n); });
+
+    // Integer exponents, the only ones FastMath::pow does not hand to libm. A plot of x^n
+    // uses the same n for every sample; it is read from an array so it isn't constant-folded.
+    auto measurePow = [&](auto kernel) {
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeats; ++r)
+            for (size_t i = 0; i < count; ++i)
+                output[i] = kernel(powBase[i], powExponent[i]);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return count * repeats / seconds / 1e6;
+    };
+    for (int n : { 2, 3, -1, 7 }) {
+        std::fill(powExponent.begin(), powExponent.end(), static_cast<float>(n));
+        double powExact = measurePow([](float x, float y) { return std::pow(x, y); });
+        double powFast = measurePow([](float x, float y) { return FastMath::pow(x, y); });
+        char name[16];
+        std::snprintf(name, sizeof(name), "x^%d", n);
+        std::printf("%-6s %12.1f %12.1f %12s %12.2fx %13s\n", name, powExact, powFast, "-", powFast / powExact, "-");
+    }
+
+    // Keep the results observable so the loops are not optimized away
+    volatile float sink = output[count / 2];
+    (void)sink;
+    return 0;
+}
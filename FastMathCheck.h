@@ -0,0 +1,8 @@
+#pragma once
+
+// Diagnostics for the FastMath kernels, reachable from the command line:
+//   GraphPlotter --check-fastmath [stride]  accuracy sweep against libm over every stride-th
+//                                           float (default 16), non-zero on failure
+//   GraphPlotter --bench-fastmath           throughput of exact vs scalar and array kernels
+int runFastMathCheck(unsigned stride);
+int runFastMathBenchmark();
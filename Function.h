@@ -1,7 +1,32 @@
 #pragma once
 
+#include "Interval.h"
+#include <limits>
+#include <stdexcept>
+
 class Function {
 public:
     virtual float evaluate(float x) const = 0;
+    // Two-variable form for z = f(x, y) plots; one-variable functions ignore y
+    virtual float evaluate(float x, float /*y*/) const { return evaluate(x); }
+    // Math errors give NaN instead of throwing; used where a throw per sample would be too costly
+    virtual float evaluateOrNaN(float x) const {
+        try {
+            return evaluate(x);
+        }
+        catch (const std::exception&) {
+            return std::numeric_limits<float>::quiet_NaN();
+        }
+    }
+    virtual float evaluateOrNaN(float x, float y) const {
+        try {
+            return evaluate(x, y);
+        }
+        catch (const std::exception&) {
+            return std::numeric_limits<float>::quiet_NaN();
+        }
+    }
+    // Bounds over [x0, x1]; functions that cannot tell report the whole line and are assumed continuous
+    virtual Interval evaluateInterval(float /*x0*/, float /*x1*/) const { return Interval::whole(); }
     virtual ~Function() = default;
 };
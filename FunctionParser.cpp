@@ -3,11 +3,11 @@
 #include <stdexcept>
 
 // This is a stub for phase 2; full parser comes in phase 3
-std::shared_ptr<Function> FunctionParser::parse(const std::string& expression) {
-    return parseExpression(expression);
+std::shared_ptr<Function> FunctionParser::parse(const std::string& expression, MathBackend backend) {
+    return parseExpression(expression, backend);
 }
 
-std::shared_ptr<Function> FunctionParser::parseExpression(const std::string& expr) {
+std::shared_ptr<Function> FunctionParser::parseExpression(const std::string& expr, MathBackend backend) {
     // Phase 2: only accept expressions like sin(x), cos(x), x^2, x, x+2
-    return std::make_shared<ExpressionTree>(expr);
+    return std::make_shared<ExpressionTree>(expr, backend);
 }
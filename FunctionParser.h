@@ -3,11 +3,12 @@
 #include <string>
 #include <memory>
 #include "Function.h"
+#include "FastMath.h"
 
 class FunctionParser {
 public:
-    std::shared_ptr<Function> parse(const std::string& expression);
+    std::shared_ptr<Function> parse(const std::string& expression, MathBackend backend = MathBackend::Exact);
 
 private:
-    std::shared_ptr<Function> parseExpression(const std::string& expr);
+    std::shared_ptr<Function> parseExpression(const std::string& expr, MathBackend backend);
 };
@@ -1,105 +1,225 @@
 //GraphRenderer.cpp
 #include "GraphRenderer.h"
+#include <algorithm>
 #include <cmath>
+#include <cstdio>       // For std::snprintf
 #include <stdexcept>    // For std::runtime_error
-#include <iomanip>      // For setting precision
-#include <sstream>      // For std::ostringstream
 
 
 // Constructor: initializes the scale and sets the default origin
 GraphRenderer::GraphRenderer()
-    : scale(50.0f), origin(0, 0) {}
+    : scale(50.0f), origin(0, 0), panOffset(0, 0),
+      curve(sf::LineStrip), gridLines(sf::Lines), areaStrip(sf::TriangleStrip) {}
 
 // Zooms in or out by scaling the graph
 void GraphRenderer::zoom(float factor) {
     scale *= factor;
 }
 
+// Pans the view; positive dx moves the graph right, positive dy moves it down
+void GraphRenderer::pan(float dx, float dy) {
+    panOffset.x += dx;
+    panOffset.y += dy;
+}
+
 void GraphRenderer::setFont(const sf::Font& f) {
     font = &f;
+    labels.clear(); // Pooled labels hold the old font
 }
 
 // Draws the graph of all user-defined functions and axes
-void GraphRenderer::draw(sf::RenderWindow& window, const std::vector<UserDefinedFunction>& functions) {
-    // Set the origin to the center of the window
-    origin = sf::Vector2f(window.getSize().x / 2.f, window.getSize().y / 2.f);
+void GraphRenderer::draw(sf::RenderTarget& target, const std::vector<UserDefinedFunction>& functions, HeatmapPlot* heatmap) {
+    // Set the origin to the center of the window, shifted by panning
+    origin = sf::Vector2f(target.getSize().x / 2.f + panOffset.x, target.getSize().y / 2.f + panOffset.y);
+
+    // Color map of z = f(x, y) goes underneath everything else
+    if (heatmap)
+        heatmap->draw(target, origin, scale);
 
     // Draw grid before anything
-    drawGrid(window, window.getSize());
+    drawGrid(target, target.getSize());
     // Draw X and Y axes
-    drawAxes(window);
+    drawAxes(target);
     // Draw axis numbers
     if (font)
-        drawAxisLabels(window, window.getSize());
+        drawAxisLabels(target, target.getSize());
 
     // Loop over each function and draw its curve
-    for (const auto& func : functions) {
-        sf::VertexArray curve(sf::LineStrip);  // Line strip for continuous curve
-        bool lastValid = false;                // Whether the previous point was valid
-
-        // Sample the function in range [-10, 10] with a step of 0.01
-        for (float x = -10.f; x <= 10.f; x += 0.01f) {
-            float y;
-
-            // Evaluate function at x and catch any math error (like log(-1), sqrt(-2), etc.)
-            try {
-                y = func.evaluate(x);
-
-                // Skip point if it's NaN or Inf
-                if (std::isnan(y) || std::isinf(y)) {
-                    lastValid = false;
-                    continue;
-                }
-            }
-            catch (const std::exception& e) {
-                // Skip point if evaluation throws an exception
+    for (const auto& func : functions)
+        drawCurve(target, func);
+}
+
+// Samples the visible x range every kPixelsPerSample pixels. A step whose interval bounds
+// cannot rule out a pole or a domain edge is bisected, and only there; the line strip is
+// broken at the sliver that still contains it after kMaxRefinements halvings.
+void GraphRenderer::drawCurve(sf::RenderTarget& target, const UserDefinedFunction& func) {
+    float left = screenToWorldX(0.f);
+    float right = screenToWorldX(static_cast<float>(target.getSize().x));
+    float step = kPixelsPerSample / scale;
+    int steps = static_cast<int>(std::ceil((right - left) / step));
+
+    curve.clear();          // Line strip for continuous curve; keeps its capacity
+    curveConnected = false;
+    refinementBudget = kMaxRefinementSpans;
+
+    addCurvePoint(target, func, left, false);
+    for (int i = 0; i < steps; ++i)
+        sampleSpan(target, func, left + i * step, std::min(left + (i + 1) * step, right), 0);
+
+    // Draw remaining part of the curve (if any)
+    if (curve.getVertexCount() > 1)
+        target.draw(curve);
+}
+
+// Extends the curve from x0 (already added) to x1
+void GraphRenderer::sampleSpan(sf::RenderTarget& target, const UserDefinedFunction& func, float x0, float x1, int depth) {
+    Interval bounds = func.evaluateInterval(x0, x1);
+
+    // Undefined all the way through, x1 included
+    if (bounds.empty) {
+        curveConnected = false;
+        return;
+    }
+
+    if (bounds.continuous) {
+        addCurvePoint(target, func, x1, true);
+        return;
+    }
+
+    // The discontinuity lies within this sliver (or the budget ran out): start a new piece at x1
+    if (depth == kMaxRefinements || refinementBudget <= 0) {
+        addCurvePoint(target, func, x1, false);
+        return;
+    }
+
+    refinementBudget -= 2;
+    float mid = 0.5f * (x0 + x1);
+    sampleSpan(target, func, x0, mid, depth + 1);
+    sampleSpan(target, func, mid, x1, depth + 1);
+}
+
+// Evaluates the function at x and appends it, joined to the previous point if connect is set
+void GraphRenderer::addCurvePoint(sf::RenderTarget& target, const UserDefinedFunction& func, float x, bool connect) {
+    // Math errors (like log(-1), sqrt(-2), etc.) come back as NaN; throwing would allocate every frame
+    float y = func.evaluateOrNaN(x);
+
+    // Skip point if it's NaN or Inf
+    if (!std::isfinite(y)) {
+        curveConnected = false;
+        return;
+    }
+
+    if (!(connect && curveConnected) && curve.getVertexCount() > 0) {
+        // If previous segment was broken, draw current curve so far
+        if (curve.getVertexCount() > 1)
+            target.draw(curve);
+        curve.clear();
+    }
+
+    // Convert world coordinates to screen coordinates
+    curve.append(sf::Vertex(worldToScreen(x, y), func.getColor()));
+    curveConnected = true;
+}
+
+// Shades the area as a single triangle strip, sampled once per pixel column.
+// Points where either curve is undefined break the strip with degenerate triangles,
+// so the whole region still goes out in one draw call.
+void GraphRenderer::drawArea(sf::RenderTarget& target, const UserDefinedFunction& upper, const UserDefinedFunction* lower,
+    float from, float to, sf::Color color) {
+    if (from > to) std::swap(from, to);
+
+    // Clip to the visible part of the x axis
+    float left = std::max(from, screenToWorldX(0.f));
+    float right = std::min(to, screenToWorldX(static_cast<float>(target.getSize().x)));
+
+    sf::VertexArray& strip = areaStrip;
+    strip.clear();
+    bool lastValid = false;
+    float step = 1.f / scale;
+
+    for (int i = 0; left < right; ++i) {
+        float x = std::min(left + i * step, right);
+        // Math errors come back as NaN and leave a gap, like values out of range
+        float yTop = upper.evaluateOrNaN(x);
+        float yBottom = lower ? lower->evaluateOrNaN(x) : 0.f;
+
+        // Do not bridge a pole between two columns with a sliver of area
+        if (lastValid && i > 0) {
+            float previous = left + (i - 1) * step;
+            if (!upper.evaluateInterval(previous, x).continuous || (lower && !lower->evaluateInterval(previous, x).continuous))
                 lastValid = false;
-                continue;
-            }
+        }
 
-            // Convert world coordinates to screen coordinates
-            sf::Vector2f screen = worldToScreen(x, y, window);
+        if (std::isfinite(yTop) && std::isfinite(yBottom)) {
+            sf::Vertex top(worldToScreen(x, yTop), color);
+            sf::Vertex bottom(worldToScreen(x, yBottom), color);
 
-            if (!lastValid && curve.getVertexCount() > 1) {
-                // If previous segment was broken, draw current curve so far
-                window.draw(curve);
-                curve.clear();
+            // Bridge the gap from the previous piece with zero-area triangles
+            if (!lastValid && strip.getVertexCount() > 0) {
+                strip.append(strip[strip.getVertexCount() - 1]);
+                strip.append(top);
             }
 
-            // Append current valid point to the curve
-            curve.append(sf::Vertex(screen, func.getColor()));
+            strip.append(top);
+            strip.append(bottom);
             lastValid = true;
         }
-
-        // Draw remaining part of the curve (if any)
-        if (curve.getVertexCount() > 1) {
-            window.draw(curve);
+        else {
+            lastValid = false;
         }
+
+        if (x >= right) break;
     }
+
+    if (strip.getVertexCount() > 2)
+        target.draw(strip);
+
+    // Mark the bounds
+    sf::Color boundColor(color.r, color.g, color.b, 255);
+    float xFrom = worldToScreenX(from);
+    float xTo = worldToScreenX(to);
+    float height = static_cast<float>(target.getSize().y);
+    sf::Vertex bounds[] = {
+        sf::Vertex(sf::Vector2f(xFrom, 0), boundColor),
+        sf::Vertex(sf::Vector2f(xFrom, height), boundColor),
+        sf::Vertex(sf::Vector2f(xTo, 0), boundColor),
+        sf::Vertex(sf::Vector2f(xTo, height), boundColor)
+    };
+    target.draw(bounds, 4, sf::Lines);
+}
+
+// Converts a pixel column to a world x coordinate
+float GraphRenderer::screenToWorldX(float px) const {
+    return (px - origin.x) / scale;
+}
+
+// Converts a world x coordinate to a pixel column
+float GraphRenderer::worldToScreenX(float x) const {
+    return origin.x + x * scale;
 }
 
 // Converts mathematical (world) coordinates to pixel (screen) coordinates
-sf::Vector2f GraphRenderer::worldToScreen(float x, float y, const sf::RenderWindow& window) const {
+sf::Vector2f GraphRenderer::worldToScreen(float x, float y) const {
     return sf::Vector2f(origin.x + x * scale, origin.y - y * scale);
 }
 
 // Draws the X and Y axes in black
-void GraphRenderer::drawAxes(sf::RenderWindow& window) {
+void GraphRenderer::drawAxes(sf::RenderTarget& target) {
     sf::Vertex xAxis[] = {
         sf::Vertex(sf::Vector2f(0, origin.y), sf::Color::Black),
-        sf::Vertex(sf::Vector2f(window.getSize().x, origin.y), sf::Color::Black)
+        sf::Vertex(sf::Vector2f(target.getSize().x, origin.y), sf::Color::Black)
     };
     sf::Vertex yAxis[] = {
         sf::Vertex(sf::Vector2f(origin.x, 0), sf::Color::Black),
-        sf::Vertex(sf::Vector2f(origin.x, window.getSize().y), sf::Color::Black)
+        sf::Vertex(sf::Vector2f(origin.x, target.getSize().y), sf::Color::Black)
     };
 
-    window.draw(xAxis, 2, sf::Lines);
-    window.draw(yAxis, 2, sf::Lines);
+    target.draw(xAxis, 2, sf::Lines);
+    target.draw(yAxis, 2, sf::Lines);
 }
 
 // Draws a grid with lines spaced evenly across the screen
-void GraphRenderer::drawGrid(sf::RenderWindow& window, const sf::Vector2u& size) {
+void GraphRenderer::drawGrid(sf::RenderTarget& target, const sf::Vector2u& size) {
     sf::Color gridColor(220, 220, 220, 120); // Light gray
     float labelStep = computeLabelStep();
     float pixelSpacing = scale * labelStep;
@@ -107,7 +227,8 @@ void GraphRenderer::drawGrid(sf::RenderWindow& window, const sf::Vector2u& size)
     int cols = size.x / pixelSpacing + 2;
     int rows = size.y / pixelSpacing + 2;
 
-    sf::VertexArray lines(sf::Lines);
+    sf::VertexArray& lines = gridLines;
+    lines.clear();
 
     // Vertical grid lines
     for (int i = -cols; i < cols; ++i) {
@@ -123,11 +244,11 @@ void GraphRenderer::drawGrid(sf::RenderWindow& window, const sf::Vector2u& size)
         lines.append(sf::Vertex(sf::Vector2f(size.x, y), gridColor));
     }
 
-    window.draw(lines);
+    target.draw(lines);
 }
 
 // Draws numeric labels on the X and Y axes
-void GraphRenderer::drawAxisLabels(sf::RenderWindow& window, const sf::Vector2u& size) {
+void GraphRenderer::drawAxisLabels(sf::RenderTarget& target, const sf::Vector2u& size) {
     if (!font) return; //avoid null pointer crash
 
     float labelStep = computeLabelStep();
@@ -136,27 +257,21 @@ void GraphRenderer::drawAxisLabels(sf::RenderWindow& window, const sf::Vector2u&
     int cols = size.x / pixelSpacing + 2;
     int rows = size.y / pixelSpacing + 2;
 
-    sf::Text label;
-    label.setFont(*font);
-    label.setCharacterSize(12);
-    label.setFillColor(sf::Color::Black);
-
     // Don't draw labels if zoom is too small
     if (pixelSpacing < 25.f)
         return;
 
+    // Labels are taken from the pool in the same order every frame, so a label keeps
+    // its value (and skips re-layout) until the zoom level changes
+    size_t used = 0;
+
     // X-axis labels
     for (int i = -cols; i < cols; ++i) {
         float value = i * labelStep;
         float x = origin.x + value * scale;
         if (std::abs(value) < 1e-3) continue;
 
-        std::ostringstream ss;
-        ss << std::fixed << std::setprecision(1) << value;
-        label.setString(ss.str());
-
-        label.setPosition(x + 2, origin.y + 4);
-        window.draw(label);
+        drawLabel(target, used, value, x + 2, origin.y + 4);
     }
 
     // Y-axis labels
@@ -165,15 +280,24 @@ void GraphRenderer::drawAxisLabels(sf::RenderWindow& window, const sf::Vector2u&
         float y = origin.y + value * scale;
         if (std::abs(value) < 1e-3) continue;
 
-        std::ostringstream ss;
-        ss << std::fixed << std::setprecision(1) << value;
-        label.setString(ss.str());
-
-        label.setPosition(origin.x + 4, y - 8);
-        window.draw(label);
+        drawLabel(target, used, value, origin.x + 4, y - 8);
     }
 }
 
+// Draws the next pooled label, growing the pool if this frame needs more than any before
+void GraphRenderer::drawLabel(sf::RenderTarget& target, size_t& used, float value, float x, float y) {
+    if (used == labels.size())
+        labels.emplace_back(*font, 12, sf::Color::Black);
+
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.1f", value);
+
+    CachedText& label = labels[used++];
+    label.setString(buffer);
+    label.get().setPosition(x, y);
+    target.draw(label.get());
+}
+
 // Calculates dynamic spacing between axis labels depending on zoom level
 float GraphRenderer::computeLabelStep() const {
     // Minimum pixel spacing between labels to avoid overlapping
@@ -3,14 +3,26 @@
 
 #include <SFML/Graphics.hpp>
 #include "UserDefinedFunction.h"
+#include "HeatmapPlot.h"
+#include "CachedText.h"
 #include <vector>
 
 class GraphRenderer {
 public:
     GraphRenderer();
 
-    void draw(sf::RenderWindow& window, const std::vector<UserDefinedFunction>& functions);
+    // Draws the heatmap (if any) under the grid, then axes, labels and curves
+    void draw(sf::RenderTarget& target, const std::vector<UserDefinedFunction>& functions, HeatmapPlot* heatmap = nullptr);
     void zoom(float factor);
+    void pan(float dx, float dy); // Moves the view by a number of pixels
+
+    // Shades the region between upper and lower (or the x axis if lower is null) over [from, to].
+    // Must be called after draw(), which fixes the origin for the current frame.
+    void drawArea(sf::RenderTarget& target, const UserDefinedFunction& upper, const UserDefinedFunction* lower,
+        float from, float to, sf::Color color);
+
+    float screenToWorldX(float px) const;
+    float worldToScreenX(float x) const;
 
     // Optional: set font externally to draw labels
     void setFont(const sf::Font& font);
@@ -18,15 +30,34 @@ public:
 private:
     float scale;              // Zoom level (pixels per unit)
     sf::Vector2f origin;      // Origin point in screen coordinates
+    sf::Vector2f panOffset;   // Origin offset from the window center, in pixels
     float gridSpacing = 1.0f; // Grid spacing in world units
     float computeLabelStep() const; // Calculate space to draw axis number
 
 
     const sf::Font* font = nullptr; // Font for axis labels (can be null)
 
-    sf::Vector2f worldToScreen(float x, float y, const sf::RenderWindow& window) const;
+    // Curve sampling: one sample per kPixelsPerSample pixels, and steps that may hold a
+    // discontinuity are halved up to kMaxRefinements times
+    static constexpr float kPixelsPerSample = 2.f;
+    static const int kMaxRefinements = 12;
+    static const int kMaxRefinementSpans = 4096; // Per curve and frame, for functions with dense poles
+
+    // Per-frame buffers, kept between frames so that a steady redraw does not allocate
+    sf::VertexArray curve;
+    bool curveConnected = false; // The next point may be joined to the end of curve
+    int refinementBudget = 0;
+    sf::VertexArray gridLines;
+    sf::VertexArray areaStrip;
+    std::vector<CachedText> labels; // Axis labels, reused in drawing order
+
+    sf::Vector2f worldToScreen(float x, float y) const;
     
-    void drawAxes(sf::RenderWindow& window);
-    void drawGrid(sf::RenderWindow& window, const sf::Vector2u& size);
-    void drawAxisLabels(sf::RenderWindow& window, const sf::Vector2u& size);
+    void drawCurve(sf::RenderTarget& target, const UserDefinedFunction& func);
+    void sampleSpan(sf::RenderTarget& target, const UserDefinedFunction& func, float x0, float x1, int depth);
+    void addCurvePoint(sf::RenderTarget& target, const UserDefinedFunction& func, float x, bool connect);
+    void drawAxes(sf::RenderTarget& target);
+    void drawGrid(sf::RenderTarget& target, const sf::Vector2u& size);
+    void drawAxisLabels(sf::RenderTarget& target, const sf::Vector2u& size);
+    void drawLabel(sf::RenderTarget& target, size_t& used, float value, float x, float y);
 };
@@ -0,0 +1,389 @@
+#include "HeatmapPlot.h"
+#include <algorithm>
+#include <cmath>
+
+HeatmapPlot::HeatmapPlot()
+    : quads(sf::Triangles), pixels(kTileSize * kTileSize * 4)
+{
+    for (int slot = kAtlasTiles * kAtlasTiles - 1; slot >= 0; --slot)
+        freeSlots.push_back(slot);
+
+    // Leave one core to the render thread
+    unsigned hardwareThreads = std::thread::hardware_concurrency();
+    unsigned threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    for (unsigned i = 0; i < threadCount; ++i)
+        workers.emplace_back(&HeatmapPlot::workerLoop, this);
+}
+
+HeatmapPlot::~HeatmapPlot() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers)
+        worker.join();
+}
+
+void HeatmapPlot::setFunction(std::shared_ptr<Function> f) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        coarseJobs.clear();
+        fineJobs.clear();
+        results.clear();
+        function = f;
+        ++version; // Tiles in flight for the old function are abandoned or dropped on arrival
+        liveVersion = version;
+    }
+
+    tiles.clear();
+    freeSlots.clear();
+    for (int slot = kAtlasTiles * kAtlasTiles - 1; slot >= 0; --slot)
+        freeSlots.push_back(slot);
+    rangeValid = false;
+}
+
+bool HeatmapPlot::hasFunction() const {
+    return function != nullptr;
+}
+
+void HeatmapPlot::draw(sf::RenderTarget& target, sf::Vector2f origin, float scale) {
+    if (!function) return;
+
+    if (atlas.getSize().x == 0)
+        atlas.create(kAtlasTiles * kTileSize, kAtlasTiles * kTileSize);
+
+    ++frame;
+
+    // A new zoom level starts a new tile generation; old tiles remain as a preview
+    if (scale != generationScale) {
+        ++generation;
+        generationScale = scale;
+        liveGeneration = generation;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        coarseJobs.clear();
+        fineJobs.clear();
+        for (auto& entry : tiles)
+            entry.second.pending = false;
+    }
+
+    collectResults();
+
+    // Tile (tx, ty) spans pixels [tx * T, (tx + 1) * T) right of the origin and [ty * T, (ty + 1) * T) above it
+    sf::Vector2u size = target.getSize();
+    int tx0 = static_cast<int>(std::floor(-origin.x / kTileSize));
+    int tx1 = static_cast<int>(std::floor((size.x - origin.x) / kTileSize));
+    int ty0 = static_cast<int>(std::floor((origin.y - size.y) / kTileSize));
+    int ty1 = static_cast<int>(std::floor(origin.y / kTileSize));
+
+    schedule(tx0, ty0, tx1, ty1);
+    uploadDirtyTiles();
+
+    quads.clear();
+
+    // Stale generations first, and only inside current tiles that have no data yet:
+    // undefined pixels are transparent, so anything drawn underneath would show through
+    for (auto it = tiles.begin(); it != tiles.end();) {
+        if (std::get<0>(it->first) == generation || !fillFromStaleTile(it->second, std::get<1>(it->first), std::get<2>(it->first),
+                origin, scale, tx0, ty0, tx1, ty1)) {
+            ++it;
+            continue;
+        }
+
+        // Everything it covered on screen is now at full resolution
+        freeSlots.push_back(it->second.slot);
+        it = tiles.erase(it);
+    }
+    for (int ty = ty0; ty <= ty1; ++ty) {
+        for (int tx = tx0; tx <= tx1; ++tx) {
+            auto it = tiles.find(TileKey(generation, tx, ty));
+            if (it != tiles.end() && it->second.step > 0)
+                addQuad(it->second, tx, ty, origin, scale);
+        }
+    }
+
+    if (quads.getVertexCount() > 0)
+        target.draw(quads, sf::RenderStates(&atlas));
+}
+
+// Screen rectangle of a tile, placed by its world rectangle at the current scale
+sf::FloatRect HeatmapPlot::tileRect(const Tile& tile, int tx, int ty, sf::Vector2f origin, float scale) const {
+    float size = kTileSize * scale / tile.scale; // kTileSize for the current generation
+    return sf::FloatRect(origin.x + tx * size, origin.y - (ty + 1) * size, size, size);
+}
+
+// Draws the parts of a stale tile that fall on visible current tiles without data yet.
+// Returns true if it overlaps the view and every current tile it overlaps is at full
+// resolution, i.e. it will never be needed again.
+bool HeatmapPlot::fillFromStaleTile(const Tile& tile, int tx, int ty, sf::Vector2f origin, float scale,
+    int tx0, int ty0, int tx1, int ty1) {
+    if (tile.step == 0) return true; // Never got any data
+
+    sf::FloatRect rect = tileRect(tile, tx, ty, origin, scale);
+    float t = static_cast<float>(kTileSize);
+
+    // Current tiles under the stale rectangle, limited to the visible ones
+    int cx0 = std::max(tx0, static_cast<int>(std::floor((rect.left - origin.x) / t)));
+    int cx1 = std::min(tx1, static_cast<int>(std::ceil((rect.left + rect.width - origin.x) / t)) - 1);
+    int cy0 = std::max(ty0, static_cast<int>(std::floor((origin.y - rect.top - rect.height) / t)));
+    int cy1 = std::min(ty1, static_cast<int>(std::ceil((origin.y - rect.top) / t)) - 1);
+    if (cx0 > cx1 || cy0 > cy1) return false;
+
+    bool superseded = true;
+    for (int cy = cy0; cy <= cy1; ++cy) {
+        for (int cx = cx0; cx <= cx1; ++cx) {
+            auto it = tiles.find(TileKey(generation, cx, cy));
+            int step = it == tiles.end() ? 0 : it->second.step;
+            if (step != 1) superseded = false;
+            if (step > 0) continue;
+
+            sf::FloatRect hole(origin.x + cx * t, origin.y - (cy + 1) * t, t, t);
+            sf::FloatRect clip;
+            if (rect.intersects(hole, clip))
+                addQuad(tile, rect, clip);
+        }
+    }
+    return superseded;
+}
+
+// Appends the two triangles of a tile, placed by its world rectangle at the current scale
+void HeatmapPlot::addQuad(const Tile& tile, int tx, int ty, sf::Vector2f origin, float scale) {
+    sf::FloatRect rect = tileRect(tile, tx, ty, origin, scale);
+    addQuad(tile, rect, rect);
+}
+
+// Appends the part of a tile drawn at rect that lies inside clip, with matching texture coordinates
+void HeatmapPlot::addQuad(const Tile& tile, const sf::FloatRect& rect, const sf::FloatRect& clip) {
+    float left = clip.left;
+    float right = clip.left + clip.width;
+    float top = clip.top;
+    float bottom = clip.top + clip.height;
+
+    float u = static_cast<float>((tile.slot % kAtlasTiles) * kTileSize);
+    float v = static_cast<float>((tile.slot / kAtlasTiles) * kTileSize);
+    float texelsPerPixel = kTileSize / rect.width;
+    float u0 = u + (left - rect.left) * texelsPerPixel;
+    float u1 = u + (right - rect.left) * texelsPerPixel;
+    float v0 = v + (top - rect.top) * texelsPerPixel;
+    float v1 = v + (bottom - rect.top) * texelsPerPixel;
+
+    sf::Vertex topLeft(sf::Vector2f(left, top), sf::Vector2f(u0, v0));
+    sf::Vertex topRight(sf::Vector2f(right, top), sf::Vector2f(u1, v0));
+    sf::Vertex bottomRight(sf::Vector2f(right, bottom), sf::Vector2f(u1, v1));
+    sf::Vertex bottomLeft(sf::Vector2f(left, bottom), sf::Vector2f(u0, v1));
+
+    quads.append(topLeft);
+    quads.append(topRight);
+    quads.append(bottomRight);
+    quads.append(topLeft);
+    quads.append(bottomRight);
+    quads.append(bottomLeft);
+}
+
+// Creates entries for visible tiles that have none and queues the next resolution pass
+void HeatmapPlot::schedule(int tx0, int ty0, int tx1, int ty1) {
+    bool queued = false;
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (int ty = ty0; ty <= ty1; ++ty) {
+        for (int tx = tx0; tx <= tx1; ++tx) {
+            TileKey key(generation, tx, ty);
+            auto it = tiles.find(key);
+
+            if (it == tiles.end()) {
+                int slot = acquireSlot();
+                if (slot < 0) continue; // Atlas full of visible tiles
+
+                Tile& tile = tiles[key];
+                tile.scale = generationScale;
+                tile.slot = slot;
+                it = tiles.find(key);
+            }
+
+            Tile& tile = it->second;
+            tile.lastUsed = frame;
+            if (tile.pending || tile.step == 1) continue;
+
+            tile.pending = true;
+            int step = tile.step == 0 ? kCoarseStep : 1;
+            Job job{ key, version, generationScale, step, function };
+            if (step == kCoarseStep) coarseJobs.push_back(job);
+            else fineJobs.push_back(job);
+            queued = true;
+        }
+    }
+
+    if (queued) wake.notify_all();
+}
+
+// Returns a free atlas slot, evicting the least recently used tile not visible this frame
+int HeatmapPlot::acquireSlot() {
+    if (!freeSlots.empty()) {
+        int slot = freeSlots.back();
+        freeSlots.pop_back();
+        return slot;
+    }
+
+    auto victim = tiles.end();
+    for (auto it = tiles.begin(); it != tiles.end(); ++it) {
+        if (it->second.lastUsed < frame && (victim == tiles.end() || it->second.lastUsed < victim->second.lastUsed))
+            victim = it;
+    }
+    if (victim == tiles.end()) return -1;
+
+    int slot = victim->second.slot;
+    tiles.erase(victim);
+    return slot;
+}
+
+// Moves finished tiles from the workers into the cache and widens the color range if needed
+void HeatmapPlot::collectResults() {
+    std::vector<Result> finished;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished.swap(results);
+    }
+
+    bool rangeChanged = false;
+
+    for (auto& result : finished) {
+        if (result.version != version) continue;
+
+        auto it = tiles.find(result.key);
+        if (it == tiles.end()) continue; // Evicted meanwhile
+
+        Tile& tile = it->second;
+        tile.pending = false;
+        if (tile.step == 1 && result.step != 1) continue; // Coarse pass finished after the full one
+
+        tile.values.swap(result.values);
+        tile.step = result.step;
+        tile.dirty = true;
+
+        for (float value : tile.values) {
+            if (!std::isfinite(value)) continue;
+            if (!rangeValid) {
+                rangeMin = rangeMax = value;
+                rangeValid = true;
+                rangeChanged = true;
+            }
+            else if (value < rangeMin || value > rangeMax) {
+                // Leave some headroom so the range does not creep one tile at a time
+                float span = std::max(rangeMax - rangeMin, 1e-6f);
+                if (value < rangeMin) rangeMin = value - 0.1f * span;
+                if (value > rangeMax) rangeMax = value + 0.1f * span;
+                rangeChanged = true;
+            }
+        }
+    }
+
+    if (rangeChanged)
+        recolorAll();
+}
+
+void HeatmapPlot::recolorAll() {
+    for (auto& entry : tiles) {
+        if (entry.second.step > 0)
+            entry.second.dirty = true;
+    }
+}
+
+// Colors and uploads changed tiles, current generation first, within a per-frame budget
+void HeatmapPlot::uploadDirtyTiles() {
+    int uploads = 0;
+    float span = rangeMax - rangeMin;
+    float invSpan = span > 0.f ? 1.f / span : 0.f;
+
+    for (int pass = 0; pass < 2; ++pass) {
+        for (auto& entry : tiles) {
+            Tile& tile = entry.second;
+            bool current = std::get<0>(entry.first) == generation;
+            if (!tile.dirty || current != (pass == 0)) continue;
+            if (uploads >= kMaxUploadsPerFrame) return;
+
+            for (int i = 0; i < kTileSize * kTileSize; ++i) {
+                float value = tile.values[i];
+                sf::Color color = std::isfinite(value) ? colormap((value - rangeMin) * invSpan) : sf::Color::Transparent;
+                pixels[i * 4 + 0] = color.r;
+                pixels[i * 4 + 1] = color.g;
+                pixels[i * 4 + 2] = color.b;
+                pixels[i * 4 + 3] = color.a;
+            }
+
+            unsigned x = static_cast<unsigned>((tile.slot % kAtlasTiles) * kTileSize);
+            unsigned y = static_cast<unsigned>((tile.slot / kAtlasTiles) * kTileSize);
+            atlas.update(pixels.data(), kTileSize, kTileSize, x, y);
+            tile.dirty = false;
+            ++uploads;
+        }
+    }
+}
+
+void HeatmapPlot::workerLoop() {
+    std::vector<float> values;
+
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this]() { return stopping || !coarseJobs.empty() || !fineJobs.empty(); });
+            if (stopping) return;
+
+            std::deque<Job>& queue = coarseJobs.empty() ? fineJobs : coarseJobs;
+            job = queue.front();
+            queue.pop_front();
+        }
+
+        if (!evaluateTile(job, values)) continue;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (job.version == version)
+            results.push_back(Result{ job.key, job.version, job.step, std::move(values) });
+        values = std::vector<float>();
+    }
+}
+
+// Samples the tile at pixel centers; a coarse pass fills step x step blocks with one sample.
+// Returns false if the function or zoom level changed while the tile was being evaluated.
+bool HeatmapPlot::evaluateTile(const Job& job, std::vector<float>& values) const {
+    values.resize(kTileSize * kTileSize);
+    int tx = std::get<1>(job.key);
+    int ty = std::get<2>(job.key);
+    float half = job.step * 0.5f;
+
+    for (int py = 0; py < kTileSize; py += job.step) {
+        if (job.version != liveVersion || std::get<0>(job.key) != liveGeneration)
+            return false;
+
+        float y = ((ty + 1) * kTileSize - py - half) / job.scale;
+
+        for (int px = 0; px < kTileSize; px += job.step) {
+            float x = (tx * kTileSize + px + half) / job.scale;
+
+            // Math errors come back as NaN; about half of a tile of sqrt(x * y) would otherwise throw
+            float z = job.function->evaluateOrNaN(x, y);
+
+            for (int by = py; by < py + job.step; ++by)
+                std::fill(values.begin() + by * kTileSize + px, values.begin() + by * kTileSize + px + job.step, z);
+        }
+    }
+
+    return true;
+}
+
+// Viridis, as a piecewise linear ramp through five of its control points
+sf::Color HeatmapPlot::colormap(float t) {
+    static const float stops[5][3] = {
+        { 68, 1, 84 }, { 59, 82, 139 }, { 33, 145, 140 }, { 94, 201, 98 }, { 253, 231, 37 }
+    };
+
+    t = std::min(std::max(t, 0.f), 1.f) * 4.f;
+    int i = std::min(static_cast<int>(t), 3);
+    float f = t - i;
+
+    return sf::Color(
+        static_cast<sf::Uint8>(stops[i][0] + (stops[i + 1][0] - stops[i][0]) * f),
+        static_cast<sf::Uint8>(stops[i][1] + (stops[i + 1][1] - stops[i][1]) * f),
+        static_cast<sf::Uint8>(stops[i][2] + (stops[i + 1][2] - stops[i][2]) * f));
+}
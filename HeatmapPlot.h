@@ -0,0 +1,117 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include "Function.h"
+
+// Color map plot of z = f(x, y).
+//
+// The plane is cut into square tiles of kTileSize pixels, keyed by their world position
+// at a given zoom level, so panning reuses every tile that is still on screen. Tiles are
+// evaluated on worker threads, first at 1/kCoarseStep resolution and then in full, and
+// only tiles whose pixels changed are uploaded to a shared texture atlas. After a zoom,
+// tiles from earlier levels fill in (stretched) where the new ones have no data yet, and
+// are dropped once everything they cover is at full resolution.
+class HeatmapPlot {
+public:
+    HeatmapPlot();
+    ~HeatmapPlot();
+
+    HeatmapPlot(const HeatmapPlot&) = delete;
+    HeatmapPlot& operator=(const HeatmapPlot&) = delete;
+
+    // Replaces the plotted function; null hides the heatmap
+    void setFunction(std::shared_ptr<Function> f);
+    bool hasFunction() const;
+
+    // Schedules missing tiles, uploads finished ones and draws the visible area
+    void draw(sf::RenderTarget& target, sf::Vector2f origin, float scale);
+
+private:
+    static const int kTileSize = 64;
+    static const int kCoarseStep = 8;
+    static const int kAtlasTiles = 32;                      // Atlas is kAtlasTiles x kAtlasTiles slots
+    static const int kMaxUploadsPerFrame = 48;
+
+    // (generation, tile x, tile y)
+    typedef std::tuple<int, int, int> TileKey;
+
+    struct Tile {
+        float scale = 0.f;
+        int step = 0;              // Resolution of the data: 0 = none yet, kCoarseStep, or 1
+        bool pending = false;      // A job for this tile is queued or running
+        bool dirty = false;        // Values changed since the last upload
+        int slot = -1;             // Atlas slot
+        unsigned long long lastUsed = 0;
+        std::vector<float> values; // kTileSize * kTileSize, row 0 at the top
+    };
+
+    struct Job {
+        TileKey key;
+        int version;
+        float scale;
+        int step;
+        std::shared_ptr<Function> function;
+    };
+
+    struct Result {
+        TileKey key;
+        int version;
+        int step;
+        std::vector<float> values;
+    };
+
+    std::shared_ptr<Function> function;
+    int version = 0;              // Bumped when the function changes
+    int generation = 0;           // Bumped when the zoom level changes
+    float generationScale = 0.f;
+    unsigned long long frame = 0;
+
+    std::map<TileKey, Tile> tiles;
+    std::vector<int> freeSlots;
+    sf::Texture atlas;
+    sf::VertexArray quads;
+    std::vector<sf::Uint8> pixels;
+
+    // Value range the color map is stretched over
+    float rangeMin = 0.f;
+    float rangeMax = 0.f;
+    bool rangeValid = false;
+
+    // Worker pool; coarse jobs are served before full-resolution ones
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Job> coarseJobs;
+    std::deque<Job> fineJobs;
+    std::vector<Result> results;
+    bool stopping = false;
+
+    // Copies of version and generation that workers poll to abandon stale tiles mid-way
+    std::atomic<int> liveVersion{ 0 };
+    std::atomic<int> liveGeneration{ 0 };
+
+    void workerLoop();
+    bool evaluateTile(const Job& job, std::vector<float>& values) const;
+
+    void collectResults();
+    void schedule(int tx0, int ty0, int tx1, int ty1);
+    void uploadDirtyTiles();
+    void recolorAll();
+    int acquireSlot();
+    sf::FloatRect tileRect(const Tile& tile, int tx, int ty, sf::Vector2f origin, float scale) const;
+    bool fillFromStaleTile(const Tile& tile, int tx, int ty, sf::Vector2f origin, float scale,
+        int tx0, int ty0, int tx1, int ty1);
+    void addQuad(const Tile& tile, int tx, int ty, sf::Vector2f origin, float scale);
+    void addQuad(const Tile& tile, const sf::FloatRect& rect, const sf::FloatRect& clip);
+
+    static sf::Color colormap(float t);
+};
@@ -0,0 +1,220 @@
+#include "Integrator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+// 15-point Kronrod nodes on [-1, 1] (positive half); odd indices are the 7-point Gauss nodes
+const double kKronrodNodes[8] = {
+    0.991455371120812639206854697526329,
+    0.949107912342758524526189684047851,
+    0.864864423359769072789712788640926,
+    0.741531185599394439863864773280788,
+    0.586087235467691130294144845693013,
+    0.405845151377397166906606412076961,
+    0.207784955007898467600689403773245,
+    0.000000000000000000000000000000000
+};
+
+const double kKronrodWeights[8] = {
+    0.022935322010529224963732008058970,
+    0.063092092629978553290700663189204,
+    0.104790010322250183839876322541518,
+    0.140653259715525918745189590510238,
+    0.169004726639267902826583426598550,
+    0.190350578064785409913256402421014,
+    0.204432940075298892414161999234649,
+    0.209482141084727828012999174891714
+};
+
+// Weights of the embedded 7-point Gauss rule, for nodes 1, 3, 5 and 7 above
+const double kGaussWeights[4] = {
+    0.129484966168869693270611432679082,
+    0.279705391489276667901467771423780,
+    0.381830050505118944950369775488975,
+    0.417959183673469387755102040816327
+};
+
+// Upper bound on bisections per adaptive call
+const int kMaxSubdivisions = 200;
+
+// Beyond this many panels the range is integrated directly instead of through the cache
+const long long kMaxCachedPanels = 4096;
+
+}
+
+Integrator::Integrator(std::shared_ptr<Function> upperFunc, std::shared_ptr<Function> lowerFunc,
+    double absTol, double relTol)
+    : upper(upperFunc), lower(lowerFunc), absTolerance(absTol), relTolerance(relTol)
+{
+    if (!upper) throw std::runtime_error("Integrator needs a function");
+}
+
+// Evaluates the integrand; math errors become NaN so they show up as non-converged
+double Integrator::sample(double x) const {
+    double y = upper->evaluateOrNaN(static_cast<float>(x));
+    if (lower) y -= lower->evaluateOrNaN(static_cast<float>(x));
+    return y;
+}
+
+// Single Gauss-Kronrod (7, 15) step; the error estimate is |K15 - G7|
+IntegrationResult Integrator::kronrod15(double from, double to) const {
+    double center = 0.5 * (from + to);
+    double halfLength = 0.5 * (to - from);
+
+    double fCenter = sample(center);
+    double kronrod = fCenter * kKronrodWeights[7];
+    double gauss = fCenter * kGaussWeights[3];
+
+    for (int i = 0; i < 7; ++i) {
+        double dx = halfLength * kKronrodNodes[i];
+        double pair = sample(center - dx) + sample(center + dx);
+        kronrod += kKronrodWeights[i] * pair;
+        if (i % 2 == 1)
+            gauss += kGaussWeights[i / 2] * pair;
+    }
+
+    IntegrationResult result;
+    result.value = kronrod * halfLength;
+    result.error = std::fabs((kronrod - gauss) * halfLength);
+    result.evaluations = 15;
+    result.converged = std::isfinite(result.value);
+    return result;
+}
+
+// Bisects the segment with the largest error until the tolerance is met
+IntegrationResult Integrator::adaptive(double from, double to) const {
+    auto worse = [](const Segment& a, const Segment& b) { return a.result.error < b.result.error; };
+    std::priority_queue<Segment, std::vector<Segment>, decltype(worse)> queue(worse);
+
+    IntegrationResult total = kronrod15(from, to);
+    if (!total.converged) return total;
+    queue.push(Segment{ from, to, total });
+
+    double absTol = absTolerance * std::max(1.0, (to - from) / panelWidth);
+
+    for (int i = 0; i < kMaxSubdivisions; ++i) {
+        if (total.error <= std::max(absTol, relTolerance * std::fabs(total.value)))
+            return total;
+
+        Segment worst = queue.top();
+        queue.pop();
+
+        double mid = 0.5 * (worst.from + worst.to);
+        Segment left{ worst.from, mid, kronrod15(worst.from, mid) };
+        Segment right{ mid, worst.to, kronrod15(mid, worst.to) };
+
+        total.value += left.result.value + right.result.value - worst.result.value;
+        total.error += left.result.error + right.result.error - worst.result.error;
+        total.evaluations += left.result.evaluations + right.result.evaluations;
+
+        if (!left.result.converged || !right.result.converged) {
+            total.converged = false;
+            return total;
+        }
+
+        queue.push(left);
+        queue.push(right);
+    }
+
+    total.converged = total.error <= std::max(absTol, relTolerance * std::fabs(total.value));
+    return total;
+}
+
+// Runs adaptive() over independent ranges, spreading them across hardware threads
+std::vector<IntegrationResult> Integrator::adaptiveParallel(const std::vector<std::pair<double, double>>& ranges) const {
+    std::vector<IntegrationResult> results(ranges.size());
+
+    size_t threadCount = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), ranges.size());
+    if (threadCount <= 1) {
+        for (size_t i = 0; i < ranges.size(); ++i)
+            results[i] = adaptive(ranges[i].first, ranges[i].second);
+        return results;
+    }
+
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threadCount; ++t) {
+        workers.emplace_back([&, t]() {
+            for (size_t i = t; i < ranges.size(); i += threadCount)
+                results[i] = adaptive(ranges[i].first, ranges[i].second);
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+
+    return results;
+}
+
+IntegrationResult Integrator::integrate(double from, double to) {
+    if (from == to) return IntegrationResult{};
+    if (from > to) {
+        IntegrationResult reversed = integrate(to, from);
+        reversed.value = -reversed.value;
+        return reversed;
+    }
+
+    // Full panels are k in [firstPanel, lastPanel)
+    long long firstPanel = static_cast<long long>(std::ceil(from / panelWidth));
+    long long lastPanel = static_cast<long long>(std::floor(to / panelWidth));
+
+    std::vector<std::pair<double, double>> ranges;
+    IntegrationResult total;
+
+    auto accumulate = [&total](const IntegrationResult& r) {
+        total.value += r.value;
+        total.error += r.error;
+        total.evaluations += r.evaluations;
+        total.converged = total.converged && r.converged;
+    };
+
+    // Huge ranges: split evenly across threads and skip the cache
+    if (lastPanel - firstPanel > kMaxCachedPanels) {
+        size_t pieces = std::max(1u, std::thread::hardware_concurrency());
+        for (size_t i = 0; i < pieces; ++i)
+            ranges.emplace_back(from + (to - from) * i / pieces, from + (to - from) * (i + 1) / pieces);
+        for (const auto& r : adaptiveParallel(ranges))
+            accumulate(r);
+        return total;
+    }
+
+    // Both bounds inside one panel: nothing to reuse
+    if (firstPanel > lastPanel)
+        return adaptive(from, to);
+
+    double leftTo = firstPanel * panelWidth;
+    double rightFrom = lastPanel * panelWidth;
+
+    bool needLeft = from < leftTo && !(leftEdge.from == from && leftEdge.to == leftTo);
+    bool needRight = rightFrom < to && !(rightEdge.from == rightFrom && rightEdge.to == to);
+
+    if (needLeft) ranges.emplace_back(from, leftTo);
+    if (needRight) ranges.emplace_back(rightFrom, to);
+
+    std::vector<long long> missing;
+    for (long long k = firstPanel; k < lastPanel; ++k) {
+        if (panels.find(k) == panels.end()) {
+            missing.push_back(k);
+            ranges.emplace_back(k * panelWidth, (k + 1) * panelWidth);
+        }
+    }
+
+    // Integrate everything that changed in one parallel batch
+    std::vector<IntegrationResult> results = adaptiveParallel(ranges);
+    size_t next = 0;
+
+    if (needLeft) leftEdge = Segment{ from, leftTo, results[next++] };
+    if (needRight) rightEdge = Segment{ rightFrom, to, results[next++] };
+    for (long long k : missing)
+        panels[k] = results[next++];
+
+    if (from < leftTo) accumulate(leftEdge.result);
+    if (rightFrom < to) accumulate(rightEdge.result);
+    for (long long k = firstPanel; k < lastPanel; ++k)
+        accumulate(panels[k]);
+
+    return total;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <vector>
+#include "Function.h"
+
+struct IntegrationResult {
+    double value = 0.0;          // Estimated definite integral
+    double error = 0.0;          // Estimated absolute error
+    int evaluations = 0;         // Function evaluations behind the value (cached panels included)
+    bool converged = true;       // False if the tolerance was not met or f was not finite
+};
+
+// Definite integrals of f(x), or of f(x) - g(x) for the area between two curves,
+// using adaptive 15-point Gauss-Kronrod quadrature.
+//
+// The x axis is split into fixed-width panels whose integrals are cached, so when
+// a bound is dragged only the panels it crosses are recomputed. Missing panels are
+// integrated in parallel.
+class Integrator {
+public:
+    Integrator(std::shared_ptr<Function> upper, std::shared_ptr<Function> lower = nullptr,
+        double absTolerance = 1e-6, double relTolerance = 1e-5);
+
+    IntegrationResult integrate(double from, double to);
+
+private:
+    struct Segment {
+        double from, to;
+        IntegrationResult result;
+    };
+
+    std::shared_ptr<Function> upper;
+    std::shared_ptr<Function> lower;
+    double absTolerance;
+    double relTolerance;
+    double panelWidth = 1.0;
+
+    std::map<long long, IntegrationResult> panels; // Full panels [k * w, (k + 1) * w]
+    Segment leftEdge{ 0.0, 0.0, {} };              // Last partial panel at the lower bound
+    Segment rightEdge{ 0.0, 0.0, {} };             // Last partial panel at the upper bound
+
+    double sample(double x) const;
+    IntegrationResult kronrod15(double from, double to) const;
+    IntegrationResult adaptive(double from, double to) const;
+    std::vector<IntegrationResult> adaptiveParallel(const std::vector<std::pair<double, double>>& ranges) const;
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <limits>
+
+// Range [lo, hi] that a function takes over a range of its arguments.
+// The bounds enclose the true range up to float rounding and may be wider than it
+// (each operation bounds its operands separately); they can be infinite.
+struct Interval {
+    float lo = 0.f;
+    float hi = 0.f;
+    bool continuous = true; // Defined and continuous over the whole argument range
+    bool empty = false;     // Defined nowhere over the argument range
+
+    Interval() = default;
+    Interval(float l, float h) : lo(l), hi(h) {}
+
+    static Interval point(float v) { return Interval(v, v); }
+    static Interval whole() {
+        return Interval(-std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity());
+    }
+
+    bool contains(float v) const { return lo <= v && v <= hi; }
+};
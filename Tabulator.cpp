@@ -0,0 +1,282 @@
+#include "Tabulator.h"
+#include "FunctionParser.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace {
+
+// Points evaluated per work item; large enough to amortize thread start-up,
+// small enough to keep the in-flight buffers to a few megabytes
+const long long kBlockSize = 1 << 16;
+
+// Buffer handed to stdio so every fwrite maps to few large OS writes
+const size_t kStreamBufferSize = 1 << 20;
+
+bool isLittleEndian() {
+    const std::uint16_t probe = 1;
+    unsigned char first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+// Appends the raw bytes of a value in little-endian order
+template <typename T>
+void appendLittleEndian(std::vector<char>& out, T value, bool swap) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    if (swap)
+        std::reverse(bytes, bytes + sizeof(T));
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+void appendCsvValue(std::vector<char>& out, float value) {
+    char text[32];
+    int len = std::snprintf(text, sizeof(text), "%.9g", value); // 9 digits round-trip a float
+    out.insert(out.end(), text, text + len);
+}
+
+void appendCsvValue(std::vector<char>& out, double value) {
+    char text[32];
+    int len = std::snprintf(text, sizeof(text), "%.17g", value); // 17 digits round-trip a double
+    out.insert(out.end(), text, text + len);
+}
+
+}
+
+Tabulator::Tabulator(const Options& opts)
+    : options(opts)
+{
+    if (options.expressions.empty())
+        throw std::runtime_error("No expression to tabulate");
+    if (options.steps < 1)
+        throw std::runtime_error("Step count must be at least 1");
+
+    FunctionParser parser;
+    for (const auto& expr : options.expressions)
+        functions.push_back(parser.parse(expr, options.backend));
+
+    // Expressions are evaluated in float: a step finer than the float spacing of the range
+    // puts several grid points on the same argument, so y repeats in runs
+    if (options.steps > 1) {
+        double step = std::fabs(options.to - options.from) / static_cast<double>(options.steps - 1);
+        float widest = static_cast<float>(std::max(std::fabs(options.from), std::fabs(options.to)));
+        double spacing = static_cast<double>(std::nextafter(widest, std::numeric_limits<float>::infinity())) - widest;
+        if (step < spacing) {
+            std::fprintf(stderr, "Warning: step %.3g is below the float spacing %.3g of the range; "
+                "expressions are evaluated in float, so neighboring points share values\n", step, spacing);
+        }
+    }
+}
+
+// Returns the x coordinate of a grid point, computed in double so the
+// spacing stays uniform even for very large step counts
+double Tabulator::gridX(long long index) const {
+    if (options.steps == 1) return options.from;
+    return options.from + (options.to - options.from) * static_cast<double>(index) / static_cast<double>(options.steps - 1);
+}
+
+// Evaluates grid points [first, first + count) and serializes them into out
+void Tabulator::evaluateBlock(long long first, long long count, std::vector<char>& out) const {
+    const bool swap = !isLittleEndian();
+    out.clear();
+
+    size_t columns = functions.size() + (options.includeX ? 1 : 0);
+    size_t valueBytes = options.format == Format::Float64 ? sizeof(double) : options.format == Format::Float32 ? sizeof(float) : 16;
+    out.reserve(static_cast<size_t>(count) * columns * valueBytes);
+
+    for (long long i = first; i < first + count; ++i) {
+        // The x column keeps the full double grid; expressions take it rounded to float
+        double gx = gridX(i);
+        float x = static_cast<float>(gx);
+
+        if (options.format == Format::Csv) {
+            if (options.includeX) {
+                appendCsvValue(out, gx);
+                if (!functions.empty()) out.push_back(',');
+            }
+        }
+        else if (options.includeX) {
+            if (options.format == Format::Float32) appendLittleEndian(out, x, swap);
+            else appendLittleEndian(out, gx, swap);
+        }
+
+        for (size_t f = 0; f < functions.size(); ++f) {
+            // Math errors (log(-1), division by zero, ...) are written as NaN, without a throw per point
+            float y = functions[f]->evaluateOrNaN(x);
+
+            if (options.format == Format::Csv) {
+                appendCsvValue(out, y);
+                if (f + 1 < functions.size()) out.push_back(',');
+            }
+            else if (options.format == Format::Float32) {
+                appendLittleEndian(out, y, swap);
+            }
+            else {
+                appendLittleEndian(out, static_cast<double>(y), swap);
+            }
+        }
+
+        if (options.format == Format::Csv) out.push_back('\n');
+    }
+}
+
+void Tabulator::writeHeader(std::FILE* out) const {
+    if (options.format != Format::Csv) return;
+
+    std::string header;
+    if (options.includeX) header += "x";
+    for (const auto& expr : options.expressions) {
+        if (!header.empty()) header += ",";
+        header += expr;
+    }
+    header += "\n";
+
+    if (std::fwrite(header.data(), 1, header.size(), out) != header.size())
+        throw std::runtime_error("Write failed");
+}
+
+void Tabulator::run() {
+    std::FILE* out = nullptr;
+    bool toStdout = options.outputPath.empty() || options.outputPath == "-";
+
+    if (toStdout) {
+        out = stdout;
+#ifdef _WIN32
+        _setmode(_fileno(stdout), _O_BINARY); // Don't let the CRT expand '\n' inside binary data
+#endif
+    }
+    else {
+        out = std::fopen(options.outputPath.c_str(), "wb");
+        if (!out) throw std::runtime_error("Cannot open output file: " + options.outputPath);
+    }
+    std::setvbuf(out, nullptr, _IOFBF, kStreamBufferSize);
+
+    unsigned threadCount = options.threads ? options.threads : std::thread::hardware_concurrency();
+    if (threadCount == 0) threadCount = 1;
+
+    const long long blockCount = (options.steps + kBlockSize - 1) / kBlockSize;
+
+    // Two buffer sets: workers fill one while the previous round is written from the other
+    std::vector<std::vector<char>> buffers[2] = {
+        std::vector<std::vector<char>>(threadCount),
+        std::vector<std::vector<char>>(threadCount)
+    };
+    std::future<void> pendingWrite;
+    int current = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    try {
+        writeHeader(out);
+
+        for (long long round = 0; round < blockCount; round += threadCount) {
+            long long roundBlocks = std::min<long long>(threadCount, blockCount - round);
+            auto& roundBuffers = buffers[current];
+
+            // Evaluate one block per thread
+            std::vector<std::thread> workers;
+            for (long long b = 0; b < roundBlocks; ++b) {
+                long long first = (round + b) * kBlockSize;
+                long long count = std::min(kBlockSize, options.steps - first);
+                workers.emplace_back(&Tabulator::evaluateBlock, this, first, count, std::ref(roundBuffers[b]));
+            }
+            for (auto& worker : workers)
+                worker.join();
+
+            // Wait for the previous round to reach the stream before queuing this one, keeping output in order
+            if (pendingWrite.valid()) pendingWrite.get();
+
+            pendingWrite = std::async(std::launch::async, [out, &roundBuffers, roundBlocks]() {
+                for (long long b = 0; b < roundBlocks; ++b) {
+                    const auto& data = roundBuffers[b];
+                    if (std::fwrite(data.data(), 1, data.size(), out) != data.size())
+                        throw std::runtime_error("Write failed");
+                }
+            });
+            current = 1 - current;
+        }
+
+        if (pendingWrite.valid()) pendingWrite.get();
+        if (std::fflush(out) != 0) throw std::runtime_error("Write failed");
+    }
+    catch (...) {
+        if (pendingWrite.valid()) pendingWrite.wait();
+        if (!toStdout) std::fclose(out);
+        throw;
+    }
+
+    if (!toStdout && std::fclose(out) != 0)
+        throw std::runtime_error("Write failed");
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double rate = seconds > 0.0 ? options.steps / seconds : 0.0;
+
+    // Report on stderr so stdout stays clean for the data itself
+    std::fprintf(stderr, "Tabulated %lld points x %zu expression(s) on %u thread(s) in %.3f s (%.3g points/s)\n",
+        options.steps, functions.size(), threadCount, seconds, rate);
+}
+
+Tabulator::Options Tabulator::parseArguments(int argc, char* argv[]) {
+    Options opts;
+
+    for (int i = 0; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("Missing value for " + arg);
+            return argv[++i];
+        };
+
+        if (arg == "--from") opts.from = std::stod(value());
+        else if (arg == "--to") opts.to = std::stod(value());
+        else if (arg == "--steps") opts.steps = std::stoll(value());
+        else if (arg == "--threads") opts.threads = static_cast<unsigned>(std::stoul(value()));
+        else if (arg == "--out") opts.outputPath = value();
+        else if (arg == "--no-x") opts.includeX = false;
+        else if (arg == "--fast") opts.backend = MathBackend::Fast;
+        else if (arg == "--format") {
+            std::string format = value();
+            if (format == "f32") opts.format = Format::Float32;
+            else if (format == "f64") opts.format = Format::Float64;
+            else if (format == "csv") opts.format = Format::Csv;
+            else throw std::runtime_error("Unknown format: " + format);
+        }
+        else if (arg.size() > 2 && arg.compare(0, 2, "--") == 0) {
+            throw std::runtime_error("Unknown option: " + arg);
+        }
+        else {
+            opts.expressions.push_back(arg);
+        }
+    }
+
+    return opts;
+}
+
+void Tabulator::printUsage(std::FILE* out) {
+    std::fprintf(out,
+        "Usage: GraphPlotter --tabulate [options] <expression>...\n"
+        "  --from <x>         First grid point (default -10)\n"
+        "  --to <x>           Last grid point (default 10)\n"
+        "  --steps <n>        Number of grid points (default 1001)\n"
+        "  --threads <n>      Worker threads (default: all cores)\n"
+        "  --format <f>       f32 | f64 (raw little-endian records) | csv\n"
+        "  --out <path>       Output file (default: stdout)\n"
+        "  --no-x             Don't write the x column\n"
+        "  --fast             Use the approximate FastMath kernels\n"
+        "Expressions are evaluated in float: y has float resolution in every format,\n"
+        "and grid points closer than the float spacing of x share the same y.\n"
+        "The x column is exact in f64 and csv, and rounded to float in f32.\n");
+}
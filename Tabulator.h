@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdio>
+#include "Function.h"
+#include "FastMath.h"
+
+// Headless mode: evaluates expressions over a uniform grid and streams the
+// values to a file or stdout, without opening a window.
+class Tabulator {
+public:
+    enum class Format { Float32, Float64, Csv };
+
+    struct Options {
+        std::vector<std::string> expressions;
+        double from = -10.0;
+        double to = 10.0;
+        long long steps = 1001;          // Number of grid points (including both ends)
+        unsigned threads = 0;            // 0 = use all hardware threads
+        Format format = Format::Float32;
+        std::string outputPath;          // Empty or "-" writes to stdout
+        bool includeX = true;            // Prefix every record with its x value
+        MathBackend backend = MathBackend::Exact;
+    };
+
+    explicit Tabulator(const Options& options);
+
+    // Evaluates the whole grid and writes it out, reporting throughput on stderr
+    void run();
+
+    // Builds options from command line arguments (after "--tabulate")
+    static Options parseArguments(int argc, char* argv[]);
+    static void printUsage(std::FILE* out);
+
+private:
+    Options options;
+    std::vector<std::shared_ptr<Function>> functions;
+
+    double gridX(long long index) const;
+    void evaluateBlock(long long first, long long count, std::vector<char>& out) const;
+    void writeHeader(std::FILE* out) const;
+};
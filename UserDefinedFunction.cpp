@@ -7,6 +7,18 @@ float UserDefinedFunction::evaluate(float x) const {
     return func->evaluate(x);
 }
 
+float UserDefinedFunction::evaluateOrNaN(float x) const {
+    return func->evaluateOrNaN(x);
+}
+
+Interval UserDefinedFunction::evaluateInterval(float x0, float x1) const {
+    return func->evaluateInterval(x0, x1);
+}
+
 sf::Color UserDefinedFunction::getColor() const {
     return drawColor;
 }
+
+std::shared_ptr<Function> UserDefinedFunction::getFunction() const {
+    return func;
+}
@@ -9,7 +9,10 @@ public:
     UserDefinedFunction(std::shared_ptr<Function> f, sf::Color color);
 
     float evaluate(float x) const;
+    float evaluateOrNaN(float x) const; // NaN where evaluate() would throw
+    Interval evaluateInterval(float x0, float x1) const;
     sf::Color getColor() const;
+    std::shared_ptr<Function> getFunction() const;
 
 private:
     std::shared_ptr<Function> func;
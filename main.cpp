@@ -1,7 +1,37 @@
 #include "Application.h"
+#include "Tabulator.h"
+#include "FastMathCheck.h"
+#include "AllocationCheck.h"
+#include <iostream>
+#include <string>
+#include <cstdlib>
 
-int main()
+int main(int argc, char* argv[])
 {
+    // Headless mode: GraphPlotter --tabulate [options] <expression>...
+    if (argc > 1 && std::string(argv[1]) == "--tabulate") {
+        try {
+            Tabulator tabulator(Tabulator::parseArguments(argc - 2, argv + 2));
+            tabulator.run();
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Tabulate error: " << e.what() << '\n';
+            Tabulator::printUsage(stderr);
+            return 1;
+        }
+        return 0;
+    }
+
+    // Diagnostics for the approximate math backend
+    if (argc > 1 && std::string(argv[1]) == "--check-fastmath")
+        return runFastMathCheck(argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 16);
+    if (argc > 1 && std::string(argv[1]) == "--bench-fastmath")
+        return runFastMathBenchmark();
+
+    // Steady-state redraw must not touch the heap (diagnostics builds only)
+    if (argc > 1 && std::string(argv[1]) == "--check-allocations")
+        return runAllocationCheck(argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 120);
+
     Application app;
     app.run();
     return 0;